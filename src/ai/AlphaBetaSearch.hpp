@@ -0,0 +1,442 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_ALPHABETASEARCH_HPP
+#define POWER4_ALPHABETASEARCH_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <memory>
+#include "../game/Power4Game.hpp"
+#include "../util/Threads.hpp"
+#include "Engine.hpp"
+#include "TranspositionTable.hpp"
+#include "OpeningBook.hpp"
+
+/**
+ * Negamax search with alpha-beta pruning and a transposition table, evaluating the leaves with Power4Game::getScore.
+ *
+ * The search runs either at a fixed depth, or by iterative deepening until a deadline (see think).
+ *
+ * With several threads, this is a "Lazy SMP" search: all threads search the same root on their own copy of the
+ * position and only share the transposition table. Half of the helper threads start one ply deeper than the others,
+ * so that the threads don't all search the same nodes at the same time and fill the table for each other.
+ */
+class AlphaBetaSearch : public Engine {
+public:
+    /**
+     * Score of a win on the next move. A win in n moves is worth WIN_SCORE - n, so that faster wins are preferred.
+     */
+    static constexpr int WIN_SCORE = 1 << 30;
+    /**
+     * getScore is clamped to this, so that no heuristic score can look like a win
+     */
+    static constexpr int MAX_HEURISTIC_SCORE = WIN_SCORE / 2;
+    static constexpr unsigned int MAX_DEPTH = 255;
+    static constexpr std::size_t DEFAULT_TABLE_BYTES = 64 << 20;
+
+private:
+    static constexpr unsigned int NO_MOVE = 0xFF;
+    /**
+     * The clock is only read every this number of nodes (must be a power of 2)
+     */
+    static constexpr std::uint64_t DEADLINE_CHECK_INTERVAL = 1024;
+    /**
+     * Xor-ed to the hash of the position when the second player is to play
+     */
+    static constexpr std::uint64_t SECOND_PLAYER_KEY = 0x5d1f0a3c2b7e9a61;
+
+    static Power4Player opponentOf(Power4Player player) {
+        return player == '1' ? '2' : '1';
+    }
+
+    static std::uint64_t keyOf(const Power4Game &game, Power4Player player) {
+        return game.getHash() ^ (player == '1' ? 0 : SECOND_PLAYER_KEY);
+    }
+
+    static int evaluate(const Power4Game &game, Power4Player player) {
+        double score = game.getScore(player);
+        if (score >= MAX_HEURISTIC_SCORE) return MAX_HEURISTIC_SCORE;
+        if (score <= -MAX_HEURISTIC_SCORE) return -MAX_HEURISTIC_SCORE;
+        return static_cast<int>(std::lround(score));
+    }
+
+    /**
+     * @return true if the score is a win or a loss rather than a heuristic
+     */
+    static bool isDecisive(int score) {
+        return score > MAX_HEURISTIC_SCORE || score < -MAX_HEURISTIC_SCORE;
+    }
+
+    /**
+     * Win scores are stored in the table relative to the position instead of the root, as the same position can be
+     * reached at different plies
+     */
+    static int toTableScore(int score, unsigned int ply) {
+        if (score > MAX_HEURISTIC_SCORE) return score + static_cast<int>(ply);
+        if (score < -MAX_HEURISTIC_SCORE) return score - static_cast<int>(ply);
+        return score;
+    }
+
+    static int fromTableScore(int score, unsigned int ply) {
+        if (score > MAX_HEURISTIC_SCORE) return score - static_cast<int>(ply);
+        if (score < -MAX_HEURISTIC_SCORE) return score + static_cast<int>(ply);
+        return score;
+    }
+
+    /**
+     * State of one search thread
+     */
+    class Worker {
+    private:
+        AlphaBetaSearch *search;
+
+    public:
+        std::uint64_t nodes = 0;
+        TranspositionStats stats;
+        unsigned int rootMove = NO_MOVE; // best move of the previous iteration, tried first at the root
+
+        explicit Worker(AlphaBetaSearch *search) : search(search) {}
+
+        [[nodiscard]] bool isStopped() const {
+            return search->stopped.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @param game the position, player is the one to play
+         * @param ply the number of moves played since the root
+         * @param bestMove set to the best column found, NO_MOVE if there is none
+         * @return the score of the position for player, meaningless if the search was stopped
+         */
+        int negamax(Power4Game &game, Power4Player player, unsigned int depth, unsigned int ply, int alpha,
+                    int beta, unsigned int &bestMove) {
+            nodes++;
+            bestMove = NO_MOVE;
+            if (nodes % DEADLINE_CHECK_INTERVAL == 0 && search->hasDeadline.load(std::memory_order_relaxed)
+                && std::chrono::steady_clock::now() >= *search->deadline) {
+                search->stopped.store(true, std::memory_order_relaxed);
+            }
+            if (isStopped()) return 0;
+            if (depth == 0) {
+                return evaluate(game, player);
+            }
+
+            const std::uint64_t key = keyOf(game, player);
+            unsigned int tableMove = ply == 0 ? rootMove : NO_MOVE;
+            stats.probes++;
+            if (std::optional<TranspositionEntry> entry = search->table.probe(key)) {
+                stats.hits++;
+                if (tableMove == NO_MOVE && entry->bestMove < game.getWidth()) tableMove = entry->bestMove;
+                if (ply > 0 && entry->depth >= depth) { // the root must always return a move of its own search
+                    int score = fromTableScore(entry->score, ply);
+                    if (entry->bound == Bound::EXACT
+                        || (entry->bound == Bound::LOWER && score >= beta)
+                        || (entry->bound == Bound::UPPER && score <= alpha)) {
+                        bestMove = tableMove;
+                        return score;
+                    }
+                }
+            }
+
+            const int originalAlpha = alpha;
+            int bestScore = -WIN_SCORE - 1;
+            const std::vector<unsigned int> &columnOrder = search->columnOrder;
+            for (unsigned int i = 0; i <= columnOrder.size(); i++) {
+                // the move from the table (or the previous iteration) is tried first, then the others in center-first
+                // order
+                unsigned int column;
+                if (i == 0) {
+                    if (tableMove == NO_MOVE) continue;
+                    column = tableMove;
+                } else {
+                    column = columnOrder[i - 1];
+                    if (column == tableMove) continue;
+                }
+                if (!game.addInColumn(column, player)) continue;
+                int score = scoreAfterMove(game, player, depth, ply, alpha, beta);
+                game.undo();
+                if (isStopped()) return 0;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestMove = column;
+                }
+                if (score > alpha) alpha = score;
+                if (alpha >= beta) break;
+            }
+            if (bestMove == NO_MOVE) {
+                return 0; // no move left, but draws are detected before
+            }
+
+            Bound bound = bestScore <= originalAlpha ? Bound::UPPER : bestScore >= beta ? Bound::LOWER : Bound::EXACT;
+            stats.stores++;
+            if (search->table.store(key, toTableScore(bestScore, ply), depth, bound, bestMove)) {
+                stats.overwrites++;
+            }
+            return bestScore;
+        }
+
+        /**
+         * @param child the position after player moved, given back as it was
+         */
+        int scoreAfterMove(Power4Game &child, Power4Player player, unsigned int depth, unsigned int ply,
+                           int alpha, int beta) {
+            if (child.hasWinner()) {
+                nodes++;
+                return WIN_SCORE - static_cast<int>(ply + 1);
+            }
+            if (child.isDraw()) {
+                nodes++;
+                return 0;
+            }
+            unsigned int ignoredMove;
+            return -negamax(child, opponentOf(player), depth - 1, ply + 1, -beta, -alpha, ignoredMove);
+        }
+
+        /**
+         * Searches the root at a single depth and reports the result to the search
+         * @return false if the search was stopped before the end
+         */
+        bool searchRoot(Power4Game &game, Power4Player player, unsigned int depth) {
+            unsigned int bestMove;
+            int score = negamax(game, player, depth, 0, -WIN_SCORE - 1, WIN_SCORE + 1, bestMove);
+            if (isStopped()) return false;
+            search->report({bestMove, score, depth, 0, {}});
+            return true;
+        }
+
+        /**
+         * Iterative deepening from firstDepth to lastDepth
+         */
+        void deepen(Power4Game &game, Power4Player player, unsigned int firstDepth, unsigned int lastDepth) {
+            for (unsigned int depth = firstDepth; depth <= lastDepth; depth++) {
+                // no need to search again the depths another thread completed
+                depth = std::clamp(search->completedDepth.load(std::memory_order_relaxed) + 1, depth, lastDepth);
+                if (!searchRoot(game, player, depth)) return;
+                SearchResult best = search->getResult();
+                if (isDecisive(best.score)) {
+                    search->stopped.store(true, std::memory_order_relaxed); // the outcome is known
+                    return;
+                }
+                rootMove = best.column;
+            }
+        }
+    };
+
+    unsigned int maxDepth;
+    unsigned int threadCount = 1;
+    bool pinThreads = false;
+    TranspositionTable table;
+    TranspositionStats tableStats; // of the last search
+    std::shared_ptr<const OpeningBook> openingBook;
+
+    // shared by the threads of a search
+    std::vector<unsigned int> columnOrder;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    std::atomic<bool> hasDeadline = false; // the deadline applies, see report
+    std::atomic<bool> stopped = false;
+    std::atomic<unsigned int> completedDepth = 0;
+    std::mutex resultMutex;
+    SearchResult result{};
+
+    /**
+     * Called by the threads when they complete an iteration, keeps the deepest one up to maxDepth: the helpers that
+     * search one ply deeper (see search) only fill the table, so that a search returns the depth it was asked for
+     */
+    void report(const SearchResult &iterationResult) {
+        std::lock_guard lock(resultMutex);
+        if (iterationResult.depth > result.depth && iterationResult.depth <= maxDepth) {
+            result.column = iterationResult.column;
+            result.score = iterationResult.score;
+            result.depth = iterationResult.depth;
+            completedDepth.store(iterationResult.depth, std::memory_order_relaxed);
+        }
+        // the first iteration is always completed, the deadline only applies after
+        hasDeadline.store(deadline.has_value(), std::memory_order_relaxed);
+    }
+
+    SearchResult getResult() {
+        std::lock_guard lock(resultMutex);
+        return result;
+    }
+
+    /**
+     * @return the move of the opening book for this position, if there is one
+     */
+    std::optional<SearchResult> probeBook(const Power4Game &game, Power4Player player) {
+        if (!openingBook || game.hasWinner() || game.isDraw()) return std::nullopt;
+        // the book only knows the positions of games started by the first player
+        if (player != (game.getMoveCount() % 2 == 0 ? '1' : '2')) return std::nullopt;
+        const auto start = std::chrono::steady_clock::now();
+        std::optional<BookEntry> entry = openingBook->probe(game);
+        if (!entry) return std::nullopt;
+        tableStats = {};
+        return SearchResult{entry->column, entry->score, entry->depth, 0, std::chrono::steady_clock::now() - start};
+    }
+
+    /**
+     * Runs a search on all the threads
+     * @param mainSearch what the first thread does, the others are stopped when it returns
+     * @param helperSearch what the other threads do, also given their index
+     */
+    template<typename MainSearch, typename HelperSearch>
+    SearchResult runWorkers(const Power4Game &game,
+                            std::optional<std::chrono::steady_clock::time_point> searchDeadline,
+                            MainSearch &&mainSearch, HelperSearch &&helperSearch) {
+        const auto start = std::chrono::steady_clock::now();
+        if (game.hasWinner() || game.isDraw()) {
+            throw std::invalid_argument("the game is over");
+        }
+        columnOrder = centerFirstColumns(game.getWidth());
+        table.newSearch();
+        deadline = searchDeadline;
+        hasDeadline = false;
+        stopped = false;
+        completedDepth = 0;
+        result = {NO_MOVE, 0, 0, 0, {}};
+
+        std::vector<Worker> workers(threadCount, Worker(this));
+        if (threadCount == 1 && !pinThreads) {
+            Power4Game root = game;
+            mainSearch(workers[0], root);
+        } else {
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount);
+            for (unsigned int i = 0; i < threadCount; i++) {
+                threads.emplace_back([&, i] {
+                    if (pinThreads) pinCurrentThread(i);
+                    Power4Game root = game;
+                    if (i == 0) {
+                        mainSearch(workers[0], root);
+                        stopped = true;
+                    } else {
+                        helperSearch(workers[i], root, i);
+                    }
+                });
+            }
+            for (std::thread &thread: threads) {
+                thread.join();
+            }
+        }
+
+        tableStats = {};
+        result.nodes = 0;
+        for (const Worker &worker: workers) {
+            tableStats += worker.stats;
+            result.nodes += worker.nodes;
+        }
+        result.elapsed = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+
+public:
+    /**
+     * @param tableBytes the memory budget of the transposition table
+     */
+    explicit AlphaBetaSearch(unsigned int depth, std::size_t tableBytes = DEFAULT_TABLE_BYTES,
+                             ReplacementPolicy replacementPolicy = ReplacementPolicy::DEPTH_PREFERRED)
+            : maxDepth(depth), table(tableBytes, replacementPolicy) {
+        if (depth == 0 || depth > MAX_DEPTH) {
+            throw std::invalid_argument("depth must be between 1 and " + std::to_string(MAX_DEPTH));
+        }
+    }
+
+    [[nodiscard]] unsigned int getDepth() const {
+        return maxDepth;
+    }
+
+    void setDepth(unsigned int depth) {
+        if (depth == 0 || depth > MAX_DEPTH) {
+            throw std::invalid_argument("depth must be between 1 and " + std::to_string(MAX_DEPTH));
+        }
+        maxDepth = depth;
+    }
+
+    [[nodiscard]] unsigned int getThreadCount() const {
+        return threadCount;
+    }
+
+    /**
+     * @param threads the number of search threads, 0 for one per hardware thread
+     */
+    void setThreadCount(unsigned int threads) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        threadCount = threads == 0 ? 1 : threads;
+    }
+
+    /**
+     * @param pin true to pin the search thread n to the CPU n
+     */
+    void setPinThreads(bool pin) {
+        pinThreads = pin;
+    }
+
+    [[nodiscard]] const TranspositionTable &getTranspositionTable() const {
+        return table;
+    }
+
+    TranspositionTable &getTranspositionTable() {
+        return table;
+    }
+
+    /**
+     * @param book an opening book, looked up before each search, or nullptr for none
+     */
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+        openingBook = std::move(book);
+    }
+
+    /**
+     * @return the use of the transposition table during the last search, summed over all threads
+     */
+    [[nodiscard]] const TranspositionStats &getTableStats() const {
+        return tableStats;
+    }
+
+    /**
+     * Searches the best column for player at the depth of this search, unless the position is in the opening book. The
+     * game must not be over.
+     */
+    SearchResult search(const Power4Game &game, Power4Player player) override {
+        if (std::optional<SearchResult> bookResult = probeBook(game, player)) return *bookResult;
+        const auto emptyCells = static_cast<unsigned int>(game.count(static_cast<Power4Player>('0')));
+        return runWorkers(
+                game, std::nullopt,
+                [&](Worker &worker, Power4Game &root) {
+                    worker.searchRoot(root, player, maxDepth);
+                },
+                [&](Worker &worker, Power4Game &root, unsigned int i) {
+                    unsigned int lastDepth = std::clamp(maxDepth + i % 2, 1u, emptyCells);
+                    worker.deepen(root, player, 1 + i % 2, lastDepth);
+                });
+    }
+
+    /**
+     * Iterative deepening: searches at depth 1, 2, 3... up to the depth of this search, and returns the result of the
+     * deepest search completed before the given time. Depth 1 is always completed. The game must not be over.
+     */
+    SearchResult think(const Power4Game &game, Power4Player player, std::chrono::milliseconds time) override {
+        if (std::optional<SearchResult> bookResult = probeBook(game, player)) return *bookResult;
+        const auto emptyCells = static_cast<unsigned int>(game.count(static_cast<Power4Player>('0')));
+        const unsigned int lastDepth = std::clamp(maxDepth, 1u, emptyCells);
+        return runWorkers(
+                game, std::chrono::steady_clock::now() + time,
+                [&](Worker &worker, Power4Game &root) {
+                    worker.deepen(root, player, 1, lastDepth);
+                },
+                [&](Worker &worker, Power4Game &root, unsigned int i) {
+                    worker.deepen(root, player, 1 + i % 2, lastDepth);
+                });
+    }
+};
+
+
+#endif //POWER4_ALPHABETASEARCH_HPP
@@ -0,0 +1,66 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_ENGINE_HPP
+#define POWER4_ENGINE_HPP
+
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "../game/Power4Game.hpp"
+
+struct SearchResult {
+    unsigned int column;
+    /**
+     * Score of the column for the player who searched, higher is better
+     */
+    int score;
+    /**
+     * The depth of the last completed search
+     */
+    unsigned int depth;
+    std::uint64_t nodes;
+    std::chrono::nanoseconds elapsed;
+
+    [[nodiscard]] double nodesPerSecond() const {
+        return elapsed.count() == 0 ? 0 : static_cast<double>(nodes) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * @return the columns of a board, starting from the center, as central discs take part in more lines
+ */
+inline std::vector<unsigned int> centerFirstColumns(unsigned int width) {
+    std::vector<unsigned int> order;
+    order.reserve(width);
+    for (unsigned int i = 0; i < width; i++) {
+        // (width - 1) / 2, then alternating to the right and to the left
+        int offset = i % 2 == 0 ? static_cast<int>(i / 2) : -static_cast<int>((i + 1) / 2);
+        if (width % 2 == 0) offset = -offset;
+        order.push_back(static_cast<unsigned int>(static_cast<int>((width - 1) / 2) + offset));
+    }
+    return order;
+}
+
+/**
+ * Something that chooses the column to play in a Power4Game
+ */
+class Engine {
+public:
+    virtual ~Engine() = default;
+
+    /**
+     * Searches the best column for player with the engine's fixed budget (like a depth). The game must not be over.
+     */
+    virtual SearchResult search(const Power4Game &game, Power4Player player) = 0;
+
+    /**
+     * Searches the best column for player, returning before the given time. The game must not be over.
+     */
+    virtual SearchResult think(const Power4Game &game, Power4Player player, std::chrono::milliseconds time) = 0;
+};
+
+
+#endif //POWER4_ENGINE_HPP
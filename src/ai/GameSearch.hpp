@@ -0,0 +1,123 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_GAMESEARCH_HPP
+#define POWER4_GAMESEARCH_HPP
+
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include "../game/Game.hpp"
+
+struct GameSearchResult {
+    unsigned int move;
+    /**
+     * Score of the move for the player who searched, higher is better
+     */
+    int score;
+    std::uint64_t nodes;
+    std::chrono::nanoseconds elapsed;
+
+    [[nodiscard]] double nodesPerSecond() const {
+        return elapsed.count() == 0 ? 0 : static_cast<double>(nodes) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * Negamax search with alpha-beta pruning at a fixed depth for any SearchableGame, evaluating the leaves with its
+ * getScore. As it is templated on the game rather than going through Game, its calls can be inlined: it is the
+ * reusable counterpart of AlphaBetaSearch, without its transposition table, move ordering and threads.
+ */
+template<SearchableGame G>
+class GameSearch {
+public:
+    typedef typename G::Player Player;
+
+    /**
+     * Score of a win on the next move, a win in n moves is worth WIN_SCORE - n like in AlphaBetaSearch
+     */
+    static constexpr int WIN_SCORE = 1 << 30;
+    /**
+     * getScore is clamped to this, so that no heuristic score can look like a win
+     */
+    static constexpr int MAX_HEURISTIC_SCORE = WIN_SCORE / 2;
+
+private:
+    static constexpr unsigned int NO_MOVE = -1;
+
+    unsigned int depth;
+    std::uint64_t nodes = 0;
+
+    static int evaluate(const G &game, const Player &player) {
+        double score = game.getScore(player);
+        if (score >= MAX_HEURISTIC_SCORE) return MAX_HEURISTIC_SCORE;
+        if (score <= -MAX_HEURISTIC_SCORE) return -MAX_HEURISTIC_SCORE;
+        return static_cast<int>(std::lround(score));
+    }
+
+    /**
+     * @param game the position, player is the one to play, given back as it was
+     * @param bestMove set to the best move found, NO_MOVE if there is none
+     * @return the score of the position for player
+     */
+    int negamax(G &game, const Player &player, unsigned int remainingDepth, unsigned int ply, int alpha, int beta,
+                unsigned int &bestMove) {
+        nodes++;
+        bestMove = NO_MOVE;
+        if (remainingDepth == 0) {
+            return evaluate(game, player);
+        }
+
+        int bestScore = -WIN_SCORE - 1;
+        const unsigned int moveSlots = game.getMoveSlots();
+        for (unsigned int move = 0; move < moveSlots; move++) {
+            if (!game.play(move, player)) continue;
+            int score;
+            if (game.hasWinner()) {
+                nodes++;
+                score = WIN_SCORE - static_cast<int>(ply + 1);
+            } else if (game.isDraw()) {
+                nodes++;
+                score = 0;
+            } else {
+                unsigned int ignoredMove;
+                score = -negamax(game, game.opponentOf(player), remainingDepth - 1, ply + 1, -beta, -alpha,
+                                 ignoredMove);
+            }
+            game.undo();
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = move;
+            }
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) break;
+        }
+        return bestMove == NO_MOVE ? 0 : bestScore; // no move left, but draws are detected before
+    }
+
+public:
+    /**
+     * @throws std::invalid_argument if depth is 0
+     */
+    explicit GameSearch(unsigned int depth) : depth(depth) {
+        if (depth == 0) throw std::invalid_argument("the depth must be at least 1");
+    }
+
+    /**
+     * Searches the best move for player, playing and undoing moves in game, which is given back as it was. The game
+     * must not be over.
+     */
+    GameSearchResult search(G &game, const Player &player) {
+        const auto start = std::chrono::steady_clock::now();
+        nodes = 0;
+        unsigned int bestMove;
+        const int score = negamax(game, player, depth, 0, -WIN_SCORE - 1, WIN_SCORE + 1, bestMove);
+        return {bestMove, score, nodes, std::chrono::steady_clock::now() - start};
+    }
+};
+
+
+#endif //POWER4_GAMESEARCH_HPP
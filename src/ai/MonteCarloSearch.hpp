@@ -0,0 +1,489 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_MONTECARLOSEARCH_HPP
+#define POWER4_MONTECARLOSEARCH_HPP
+
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../game/BitBoard.hpp"
+#include "../util/Arena.hpp"
+#include "Engine.hpp"
+
+/**
+ * Monte Carlo tree search (UCT): plays many quick random games (playouts) from the position, growing a tree of the
+ * moves that did best so far, and plays the most visited move. It doesn't use Power4Game::getScore at all.
+ *
+ * The playouts are random, except that a player always wins when they can and blocks the opponent's wins (this can be
+ * turned off with setBiasedPlayouts). The tree is kept between searches: if the new position is a move or two after
+ * the previous one, the search starts from the matching subtree.
+ *
+ * With several threads, all threads grow the same tree. A thread going down the tree counts a visit right away, and
+ * only adds the result of the playout at the end: until then the visit looks like a loss (a "virtual loss"), which
+ * sends the other threads to other branches.
+ *
+ * The nodes live in an Arena, so growing the tree never calls the global allocator, and positions are BitBoard
+ * copies on the stack: the search loop doesn't allocate at all. There are two arenas: to keep a subtree for the next
+ * search, it is copied to the spare arena, and the other one is reset at once. When the arena is full, the tree stops
+ * growing and the playouts go on from its leaves.
+ *
+ * Only works on boards that fit in a BitBoard.
+ */
+class MonteCarloSearch : public Engine {
+public:
+    static constexpr double DEFAULT_EXPLORATION = 1.4;
+    static constexpr std::size_t DEFAULT_TREE_BYTES = 256 << 20;
+
+private:
+    enum class NodeState : std::uint8_t {
+        LEAF,
+        EXPANDING, // a thread is adding the children
+        EXPANDED
+    };
+
+    enum class Outcome : std::uint8_t {
+        NONE,
+        WIN, // the player who moved to the node won
+        DRAW
+    };
+
+    struct Node {
+        /**
+         * The visits, including the ones of the playouts that are still running
+         */
+        std::atomic<std::uint32_t> visits{0};
+        /**
+         * Twice the wins plus the draws of the player who moved to this node
+         */
+        std::atomic<std::uint32_t> points{0};
+        std::atomic<NodeState> state{NodeState::LEAF};
+        std::uint8_t column = 0;
+        Outcome outcome = Outcome::NONE;
+        std::uint8_t childCount = 0;
+        Node *children = nullptr; // in the arena
+    };
+
+    /**
+     * The nodes visited by an iteration, from the root
+     */
+    struct Path {
+        std::array<Node *, 65> nodes; // a BitBoard has less than 64 cells
+        unsigned int size = 0;
+    };
+
+    /**
+     * Enough for the root and its children
+     */
+    static constexpr std::size_t MIN_ARENA_BYTES = 4096;
+
+    std::uint64_t playoutBudget;
+    unsigned int threadCount = 1;
+    double exploration = DEFAULT_EXPLORATION;
+    bool biasedPlayouts = true;
+
+    std::array<std::unique_ptr<Arena>, 2> arenas; // the tree is in the first one
+    Node *root = nullptr;
+    std::optional<BitBoard> rootBoard;
+    unsigned int rootMoves = 0;
+    std::vector<unsigned int> columnOrder;
+
+    // shared by the threads of a search
+    std::atomic<std::uint64_t> playouts = 0;
+    std::atomic<unsigned int> maxDepth = 0;
+    std::atomic<bool> stopped = false;
+
+    std::uint64_t seed = 0;
+    std::uint64_t searchCount = 0; // since the seed was set, each search seeds its threads differently
+
+    /**
+     * @return the cells of this player that would win if played now
+     */
+    static std::uint64_t winningMoves(const BitBoard &board, unsigned int playerIndex) {
+        return BitBoard::threats(board.discs(playerIndex), board.getHeight()) & board.playableCells();
+    }
+
+    static unsigned int columnOf(const BitBoard &board, std::uint64_t cell) {
+        return static_cast<unsigned int>(std::countr_zero(cell)) / (board.getHeight() + 1);
+    }
+
+    /**
+     * @return a random bit of a mask that isn't empty
+     */
+    static std::uint64_t randomBit(std::uint64_t mask, std::mt19937_64 &random) {
+        for (auto n = random() % static_cast<unsigned int>(std::popcount(mask)); n > 0; n--) {
+            mask &= mask - 1;
+        }
+        return mask & -mask;
+    }
+
+    /**
+     * Plays random moves until the end of the game
+     * @param moves the number of moves played on the board
+     * @return the index of the winner (0 or 1), or -1 for a draw
+     */
+    int playout(BitBoard board, unsigned int moves, std::mt19937_64 &random) const {
+        while (true) {
+            const std::uint64_t playable = board.playableCells();
+            if (!playable) return -1;
+            const unsigned int player = moves % 2;
+            std::uint64_t cell;
+            if (biasedPlayouts) {
+                if (winningMoves(board, player)) return static_cast<int>(player);
+                const std::uint64_t blocks = winningMoves(board, 1 - player);
+                cell = blocks ? blocks & -blocks : randomBit(playable, random);
+            } else {
+                cell = randomBit(playable, random);
+            }
+            board.play(columnOf(board, cell), player);
+            moves++;
+            if (!biasedPlayouts && board.hasFour(board.discs(player))) return static_cast<int>(player);
+        }
+    }
+
+    /**
+     * Adds a child to the node for each column that isn't full. Only one thread expands a node, the others find it
+     * still expanding and do a playout from it.
+     * @param board the position of the node, moves the number of moves played in it
+     * @return true if this thread expanded the node
+     */
+    bool expand(Node &node, const BitBoard &board, unsigned int moves) {
+        NodeState expected = NodeState::LEAF;
+        if (!node.state.compare_exchange_strong(expected, NodeState::EXPANDING, std::memory_order_acquire)) {
+            return false;
+        }
+        const unsigned int player = moves % 2;
+        const std::uint64_t wins = winningMoves(board, player);
+        const bool isLastMove = moves + 1 == board.getWidth() * board.getHeight();
+        Node *children = arenas[0]->create<Node>(std::popcount(board.playableCells()));
+        if (children == nullptr) {
+            node.state.store(NodeState::LEAF, std::memory_order_relaxed); // the arena is full, stay a leaf
+            return false;
+        }
+        unsigned int count = 0;
+        for (unsigned int column: columnOrder) {
+            if (!board.canPlay(column)) continue;
+            Node &child = children[count++];
+            child.column = static_cast<std::uint8_t>(column);
+            BitBoard next = board;
+            if (wins & next.play(column, player)) child.outcome = Outcome::WIN;
+            else if (isLastMove) child.outcome = Outcome::DRAW;
+        }
+        node.children = children;
+        node.childCount = static_cast<std::uint8_t>(count);
+        node.state.store(NodeState::EXPANDED, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @return the child with the best upper confidence bound, an unvisited one if any
+     */
+    Node &select(const Node &node) const {
+        const double logVisits = std::log(static_cast<double>(node.visits.load(std::memory_order_relaxed)) + 1);
+        Node *best = nullptr;
+        double bestValue = -1;
+        for (unsigned int i = 0; i < node.childCount; i++) {
+            Node &child = node.children[i];
+            const std::uint32_t visits = child.visits.load(std::memory_order_relaxed);
+            if (visits == 0) return child;
+            const double mean = child.points.load(std::memory_order_relaxed) / (2.0 * visits);
+            const double value = mean + exploration * std::sqrt(logVisits / visits);
+            if (value > bestValue) {
+                bestValue = value;
+                best = &child;
+            }
+        }
+        return *best;
+    }
+
+    /**
+     * Goes down the tree, expands a leaf, plays a playout from it and adds its result to the nodes visited
+     */
+    void iterate(std::mt19937_64 &random, Path &path) {
+        BitBoard board = *rootBoard;
+        unsigned int moves = rootMoves;
+        Node *node = root;
+        node->visits.fetch_add(1, std::memory_order_relaxed);
+        path.nodes[0] = node;
+        path.size = 1;
+        // a node is expanded on its second visit, so that the leaves that are visited once cost no memory
+        while (node->outcome == Outcome::NONE
+               && (node->state.load(std::memory_order_acquire) == NodeState::EXPANDED
+                   || (node->visits.load(std::memory_order_relaxed) > 1 && expand(*node, board, moves)))) {
+            node = &select(*node);
+            node->visits.fetch_add(1, std::memory_order_relaxed);
+            board.play(node->column, moves % 2);
+            moves++;
+            path.nodes[path.size++] = node;
+        }
+
+        int winner;
+        if (node->outcome == Outcome::WIN) winner = static_cast<int>((moves - 1) % 2);
+        else if (node->outcome == Outcome::DRAW) winner = -1;
+        else winner = playout(board, moves, random);
+
+        for (unsigned int depth = 1; depth < path.size; depth++) {
+            const unsigned int mover = (rootMoves + depth - 1) % 2;
+            if (winner < 0) path.nodes[depth]->points.fetch_add(1, std::memory_order_relaxed);
+            else if (static_cast<unsigned int>(winner) == mover) {
+                path.nodes[depth]->points.fetch_add(2, std::memory_order_relaxed);
+            }
+        }
+        const unsigned int depth = path.size - 1;
+        unsigned int deepest = maxDepth.load(std::memory_order_relaxed);
+        while (depth > deepest && !maxDepth.compare_exchange_weak(deepest, depth, std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * Copies a subtree to another arena, as much of it as fits
+     */
+    static void copySubtree(const Node &from, Node &to, Arena &arena) {
+        to.visits.store(from.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.points.store(from.points.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.column = from.column;
+        to.outcome = from.outcome;
+        if (from.state.load(std::memory_order_acquire) != NodeState::EXPANDED) return;
+        Node *children = arena.create<Node>(from.childCount);
+        if (children == nullptr) return; // the copy stays a leaf
+        for (unsigned int i = 0; i < from.childCount; i++) {
+            copySubtree(from.children[i], children[i], arena);
+        }
+        to.children = children;
+        to.childCount = from.childCount;
+        to.state.store(NodeState::EXPANDED, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return the node of the target position under this node, or nullptr
+     */
+    static const Node *findSubtree(const Node &node, const BitBoard &board, unsigned int moves,
+                                   const BitBoard &target, unsigned int targetMoves) {
+        if (node.state.load(std::memory_order_acquire) != NodeState::EXPANDED) return nullptr;
+        for (unsigned int i = 0; i < node.childCount; i++) {
+            const Node &child = node.children[i];
+            BitBoard next = board;
+            next.play(child.column, moves % 2);
+            if (moves + 1 == targetMoves) {
+                if (next.key() == target.key()) return &child;
+            } else if (const Node *found = findSubtree(child, next, moves + 1, target, targetMoves)) {
+                return found;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Makes the root match the position, keeping the subtree of the previous search if the position is one or two
+     * moves after the previous root
+     */
+    void moveRoot(const BitBoard &board, unsigned int moves) {
+        if (root != nullptr && rootBoard && rootBoard->getWidth() == board.getWidth()
+            && rootBoard->getHeight() == board.getHeight()) {
+            if (moves == rootMoves && rootBoard->key() == board.key()) return;
+            if (moves == rootMoves + 1 || moves == rootMoves + 2) {
+                const Node *subtree = findSubtree(*root, *rootBoard, rootMoves, board, moves);
+                arenas[1]->reset();
+                // without room for the copy, the search starts from a new root
+                if (Node *copy = subtree != nullptr ? arenas[1]->create<Node>() : nullptr) {
+                    copySubtree(*subtree, *copy, *arenas[1]);
+                    root = copy;
+                    std::swap(arenas[0], arenas[1]);
+                    arenas[1]->reset(); // the rest of the old tree
+                    rootBoard = board;
+                    rootMoves = moves;
+                    // keep the subtree only if it leaves room to grow
+                    if (arenas[0]->getUsed() <= arenas[0]->getCapacity() / 2) return;
+                }
+            }
+        }
+        arenas[0]->reset();
+        root = arenas[0]->create<Node>();
+        rootBoard = board;
+        rootMoves = moves;
+    }
+
+    template<typename ShouldStop>
+    SearchResult run(const Power4Game &game, ShouldStop &&shouldStop) {
+        const auto start = std::chrono::steady_clock::now();
+        const BitBoard *board = game.getBitBoard();
+        if (board == nullptr) {
+            throw std::invalid_argument("Monte Carlo search only works on boards of at most 64 cells with a row on top");
+        }
+        if (game.hasWinner() || game.isDraw()) {
+            throw std::invalid_argument("the game is over");
+        }
+        columnOrder = centerFirstColumns(game.getWidth());
+        moveRoot(*board, game.getMoveCount());
+        playouts = 0;
+        maxDepth = 0;
+        stopped = false;
+        const std::uint64_t firstStream = searchCount++ * threadCount;
+
+        auto work = [&](unsigned int index) {
+            std::mt19937_64 random(seed ^ 0x9e3779b97f4a7c15 * (firstStream + index + 1));
+            Path path;
+            while (!stopped.load(std::memory_order_relaxed)) {
+                iterate(random, path);
+                if (shouldStop(playouts.fetch_add(1, std::memory_order_relaxed) + 1)) {
+                    stopped.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+        if (threadCount == 1) {
+            work(0);
+        } else {
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount);
+            for (unsigned int i = 0; i < threadCount; i++) {
+                threads.emplace_back(work, i);
+            }
+            for (std::thread &thread: threads) {
+                thread.join();
+            }
+        }
+
+        // the root was visited at least twice, so it was expanded
+        const Node *best = nullptr;
+        for (unsigned int i = 0; i < root->childCount; i++) {
+            const Node &child = root->children[i];
+            if (child.outcome == Outcome::WIN) {
+                best = &child;
+                break;
+            }
+            if (best == nullptr || child.visits.load() > best->visits.load()) best = &child;
+        }
+        const std::uint32_t visits = best->visits.load();
+        const int score = visits == 0 ? 0 : static_cast<int>(std::lround(500.0 * best->points.load() / visits));
+        return {best->column, score, maxDepth.load(), playouts.load(), std::chrono::steady_clock::now() - start};
+    }
+
+public:
+    /**
+     * @param playouts the number of playouts of search, at least 2
+     * @param treeBytes the memory budget of the tree, half of it holds the tree and the other half is used to keep a
+     * subtree for the next search
+     * @param seed see setSeed
+     */
+    explicit MonteCarloSearch(std::uint64_t playouts, std::size_t treeBytes = DEFAULT_TREE_BYTES,
+                              std::uint64_t seed = 0)
+            : playoutBudget(playouts), seed(seed) {
+        if (playouts < 2) {
+            throw std::invalid_argument("Monte Carlo search needs at least 2 playouts");
+        }
+        if (treeBytes < 2 * MIN_ARENA_BYTES) {
+            throw std::invalid_argument("the tree of a Monte Carlo search needs at least "
+                                        + std::to_string(2 * MIN_ARENA_BYTES) + " bytes");
+        }
+        for (std::unique_ptr<Arena> &arena: arenas) {
+            arena = std::make_unique<Arena>(treeBytes / 2);
+        }
+    }
+
+    [[nodiscard]] std::uint64_t getPlayouts() const {
+        return playoutBudget;
+    }
+
+    void setPlayouts(std::uint64_t playouts) {
+        if (playouts < 2) {
+            throw std::invalid_argument("Monte Carlo search needs at least 2 playouts");
+        }
+        playoutBudget = playouts;
+    }
+
+    [[nodiscard]] unsigned int getThreadCount() const {
+        return threadCount;
+    }
+
+    /**
+     * @param threads the number of search threads, 0 for one per hardware thread
+     */
+    void setThreadCount(unsigned int threads) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        threadCount = threads == 0 ? 1 : threads;
+    }
+
+    /**
+     * @param constant how much less visited moves are tried, the C of UCT
+     */
+    void setExploration(double constant) {
+        exploration = constant;
+    }
+
+    /**
+     * @param biased false for playouts that are fully random, true (the default) to always take and block wins
+     */
+    void setBiasedPlayouts(bool biased) {
+        biasedPlayouts = biased;
+    }
+
+    /**
+     * Seeds the playouts. With one thread, the searches that follow a clearTree and a setSeed always play the same
+     * playouts, whatever was searched before.
+     */
+    void setSeed(std::uint64_t newSeed) {
+        seed = newSeed;
+        searchCount = 0;
+    }
+
+    /**
+     * @return the bytes used by the tree
+     */
+    [[nodiscard]] std::size_t getTreeBytes() const {
+        return arenas[0]->getUsed();
+    }
+
+    /**
+     * @return the number of arena allocations of the tree (one per expanded node, plus the root)
+     */
+    [[nodiscard]] std::uint64_t getTreeAllocations() const {
+        return arenas[0]->getAllocations();
+    }
+
+    /**
+     * Forgets the tree of the previous searches
+     */
+    void clearTree() {
+        arenas[0]->reset();
+        arenas[1]->reset();
+        root = nullptr;
+        rootBoard.reset();
+    }
+
+    /**
+     * Runs the number of playouts of this search. The game must not be over.
+     * @return the most visited column, its score in thousandths (1000 if it always won, 500 for as many wins as losses)
+     * and the depth of the tree. SearchResult::nodes is the number of playouts.
+     */
+    SearchResult search(const Power4Game &game, Power4Player) override {
+        return run(game, [&](std::uint64_t done) {
+            return done >= playoutBudget;
+        });
+    }
+
+    /**
+     * Like search, but runs playouts until the given time, whatever the number of playouts of this search.
+     */
+    SearchResult think(const Power4Game &game, Power4Player, std::chrono::milliseconds time) override {
+        const auto deadline = std::chrono::steady_clock::now() + time;
+        return run(game, [&](std::uint64_t done) {
+            // at least 2 playouts to expand the root, and the clock is only read every 256 playouts
+            return done >= 2 && done % 256 == 0 && std::chrono::steady_clock::now() >= deadline;
+        });
+    }
+};
+
+
+#endif //POWER4_MONTECARLOSEARCH_HPP
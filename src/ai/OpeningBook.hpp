@@ -0,0 +1,143 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_OPENINGBOOK_HPP
+#define POWER4_OPENINGBOOK_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../util/MappedFile.hpp"
+
+/**
+ * A position of the book and the best move found for it, 16 bytes in the file
+ */
+struct BookEntry {
+    std::uint64_t key; // see OpeningBook::canonicalKey
+    std::int32_t score; // for the player to move, like SearchResult::score
+    std::uint8_t column;
+    std::uint8_t depth; // of the search that found the move
+    std::uint8_t padding[2]{};
+
+    bool operator<(const BookEntry &other) const {
+        return key < other.key;
+    }
+};
+static_assert(sizeof(BookEntry) == 16);
+
+/**
+ * Best moves of the first positions of a board, read from a file written by the Power4Book tool.
+ *
+ * File format (little endian): a BookHeader, then the entries sorted by key. A position and its mirror image have the
+ * same best move (mirrored), so only one of them is stored, see canonicalKey.
+ *
+ * The file is mapped in memory rather than read, and looked up by binary search: opening a book is instant and only
+ * the pages that are searched are loaded.
+ */
+class OpeningBook {
+public:
+    struct BookHeader {
+        std::array<char, 4> magic;
+        std::uint32_t version;
+        std::uint32_t width, height;
+        std::uint64_t entryCount;
+    };
+    static_assert(sizeof(BookHeader) == 24);
+
+    static constexpr std::array<char, 4> MAGIC = {'P', '4', 'B', 'K'};
+    static constexpr std::uint32_t VERSION = 1;
+
+private:
+    MappedFile file;
+    BookHeader header{};
+    const BookEntry *entries = nullptr;
+
+public:
+    /**
+     * @throws std::runtime_error if the file can't be read or isn't a valid book
+     */
+    explicit OpeningBook(const std::string &path) : file(path) {
+        if (file.getSize() < sizeof(BookHeader)) {
+            throw std::runtime_error(path + " is not an opening book");
+        }
+        std::memcpy(&header, file.getData(), sizeof(BookHeader));
+        if (header.magic != MAGIC || header.version != VERSION) {
+            throw std::runtime_error(path + " is not an opening book of version " + std::to_string(VERSION));
+        }
+        if (file.getSize() != sizeof(BookHeader) + header.entryCount * sizeof(BookEntry)) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        // the mapping is page aligned and the header is 24 bytes, so the entries are aligned
+        entries = reinterpret_cast<const BookEntry *>(file.getData() + sizeof(BookHeader));
+    }
+
+    /**
+     * @param mirrored set to true if the key is the one of the mirror image of the position
+     * @return the smallest of the keys of the position and of its mirror image
+     */
+    static std::uint64_t canonicalKey(const BitBoard &bitBoard, bool &mirrored) {
+        std::uint64_t key = bitBoard.key();
+        std::uint64_t mirrorKey = bitBoard.mirrored().key();
+        mirrored = mirrorKey < key;
+        return mirrored ? mirrorKey : key;
+    }
+
+    /**
+     * Writes a book, in any order. Entries with the same key must be equal.
+     */
+    static void write(const std::string &path, unsigned int width, unsigned int height,
+                      std::vector<BookEntry> bookEntries) {
+        std::sort(bookEntries.begin(), bookEntries.end());
+        BookHeader bookHeader{MAGIC, VERSION, width, height, bookEntries.size()};
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&bookHeader), sizeof(bookHeader));
+        out.write(reinterpret_cast<const char *>(bookEntries.data()),
+                  static_cast<std::streamsize>(bookEntries.size() * sizeof(BookEntry)));
+        if (!out) {
+            throw std::runtime_error("cannot write " + path);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return header.entryCount;
+    }
+
+    [[nodiscard]] unsigned int getWidth() const {
+        return header.width;
+    }
+
+    [[nodiscard]] unsigned int getHeight() const {
+        return header.height;
+    }
+
+    /**
+     * @return the entry of the position, with the column of the move in this position (not in its mirror image), or
+     * nothing if the position isn't in the book or the board has another size
+     */
+    [[nodiscard]] std::optional<BookEntry> probe(const Power4Game &game) const {
+        const BitBoard *bitBoard = game.getBitBoard();
+        if (bitBoard == nullptr || game.getWidth() != header.width || game.getHeight() != header.height) {
+            return std::nullopt;
+        }
+        bool mirrored;
+        const std::uint64_t key = canonicalKey(*bitBoard, mirrored);
+        const BookEntry *end = entries + header.entryCount;
+        const BookEntry *found = std::lower_bound(entries, end, BookEntry{key, 0, 0, 0});
+        if (found == end || found->key != key) return std::nullopt;
+        BookEntry entry = *found;
+        if (mirrored) entry.column = static_cast<std::uint8_t>(header.width - 1 - entry.column);
+        return entry;
+    }
+};
+
+
+#endif //POWER4_OPENINGBOOK_HPP
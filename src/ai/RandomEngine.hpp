@@ -0,0 +1,54 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_RANDOMENGINE_HPP
+#define POWER4_RANDOMENGINE_HPP
+
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include "Engine.hpp"
+
+/**
+ * Plays a random column among the ones that are not full. A baseline for the other engines, and a fast opponent to
+ * generate games.
+ */
+class RandomEngine : public Engine {
+private:
+    std::mt19937_64 random;
+
+public:
+    explicit RandomEngine(std::uint64_t seed = 0) : random(seed) {}
+
+    void reseed(std::uint64_t seed) {
+        random.seed(seed);
+    }
+
+    /**
+     * Plays at once. The game must not be over.
+     */
+    SearchResult search(const Power4Game &game, Power4Player) override {
+        const auto start = std::chrono::steady_clock::now();
+        std::array<unsigned int, 64> columns{};
+        unsigned int count = 0;
+        for (unsigned int column = 0; column < game.getWidth() && count < columns.size(); column++) {
+            if (game.getColumnHeight(column) < game.getHeight()) columns[count++] = column;
+        }
+        if (count == 0 || game.hasWinner()) {
+            throw std::invalid_argument("the game is over");
+        }
+        const unsigned int column = columns[std::uniform_int_distribution<unsigned int>(0, count - 1)(random)];
+        return {column, 0, 0, 1, std::chrono::steady_clock::now() - start};
+    }
+
+    SearchResult think(const Power4Game &game, Power4Player player, std::chrono::milliseconds) override {
+        return search(game, player);
+    }
+};
+
+
+#endif //POWER4_RANDOMENGINE_HPP
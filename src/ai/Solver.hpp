@@ -0,0 +1,318 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_SOLVER_HPP
+#define POWER4_SOLVER_HPP
+
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../game/BitBoard.hpp"
+#include "Engine.hpp"
+#include "TranspositionTable.hpp"
+
+struct SolveResult {
+    /**
+     * Game-theoretic value of the position for the player to play: 0 for a draw, positive for a win and negative for a
+     * loss. The sooner the game ends, the greater the absolute value: on a 7x6 board, winning with one's k-th disc
+     * scores 22 - k, and losing to the k-th disc of the opponent scores k - 22 (see Solver::pliesToEnd).
+     */
+    int score;
+    /**
+     * Number of moves left to play by both players with perfect play, including the last one
+     */
+    unsigned int plies;
+    std::uint64_t nodes;
+    std::chrono::nanoseconds elapsed;
+
+    [[nodiscard]] double nodesPerSecond() const {
+        return elapsed.count() == 0 ? 0 : static_cast<double>(nodes) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * Perfect play: finds the exact outcome of a position, searching until the end of the game.
+ *
+ * The score is narrowed by null-window searches (is the score above x?), which cut much more than a full window. The
+ * search only tries moves that don't let the opponent win on the next move, plays the forced moves right away, and
+ * tries first the moves that create the most threats. A transposition table remembers the bounds found for each
+ * position.
+ *
+ * Only works on boards that fit in a BitBoard, and assumes the players alternated, starting with the first one.
+ */
+class Solver {
+public:
+    static constexpr std::size_t DEFAULT_TABLE_BYTES = 64 << 20;
+
+private:
+    static constexpr unsigned int NO_MOVE = 0xFF;
+    static constexpr unsigned int MAX_WIDTH = 64;
+
+    /**
+     * A position as seen by the player to play: their discs and all the discs, in the layout of BitBoard
+     */
+    struct Position {
+        std::uint64_t current;
+        std::uint64_t mask;
+        unsigned int moves;
+    };
+
+    struct Move {
+        std::uint64_t cell;
+        int priority;
+        unsigned int column;
+    };
+
+    unsigned int width, height, cellCount;
+    std::uint64_t bottomMask, boardMask;
+    std::vector<unsigned int> columnOrder;
+    TranspositionTable table;
+    std::uint64_t nodes = 0;
+
+    [[nodiscard]] std::uint64_t columnMask(unsigned int column) const {
+        return ((std::uint64_t{1} << height) - 1) << (column * (height + 1));
+    }
+
+    [[nodiscard]] std::uint64_t playableCells(const Position &position) const {
+        return (position.mask + bottomMask) & boardMask;
+    }
+
+    /**
+     * @return the empty cells where these discs would complete a line of 4
+     */
+    [[nodiscard]] std::uint64_t winningCells(std::uint64_t discs, std::uint64_t mask) const {
+        return BitBoard::threats(discs, height) & (boardMask ^ mask);
+    }
+
+    [[nodiscard]] bool canWinNext(const Position &position) const {
+        return winningCells(position.current, position.mask) & playableCells(position);
+    }
+
+    /**
+     * Must only be called if the player to play can't win right away
+     * @return the moves that don't let the opponent win on the next move
+     */
+    [[nodiscard]] std::uint64_t nonLosingMoves(const Position &position) const {
+        std::uint64_t playable = playableCells(position);
+        std::uint64_t opponentWins = winningCells(position.current ^ position.mask, position.mask);
+        std::uint64_t forced = playable & opponentWins;
+        if (forced) {
+            if (forced & (forced - 1)) return 0; // two threats can't both be blocked
+            playable = forced;
+        }
+        return playable & ~(opponentWins >> 1); // don't play under a threat of the opponent
+    }
+
+    /**
+     * @return a mix of the bits of the unique key of the position, as the table chooses the bucket by the lowest bits
+     */
+    static std::uint64_t tableKey(const Position &position) {
+        std::uint64_t key = position.current + position.mask; // same as BitBoard::key up to a constant
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111eb;
+        return key ^ (key >> 31);
+    }
+
+    [[nodiscard]] int winScore(unsigned int moves) const {
+        return static_cast<int>(cellCount + 1 - moves) / 2;
+    }
+
+    /**
+     * Must only be called if the player to play can't win right away
+     * @return the score of the position if it is between alpha and beta, else a bound of the score on the same side
+     */
+    int negamax(const Position &position, int alpha, int beta) {
+        nodes++;
+        const std::uint64_t moves = nonLosingMoves(position);
+        if (moves == 0) return -static_cast<int>(cellCount - position.moves) / 2; // the opponent wins next move
+        if (position.moves + 2 >= cellCount) return 0; // nobody can win with the last 2 discs
+
+        // the opponent can't win on their next move, and we can't on this one
+        const int lowest = -static_cast<int>(cellCount - 2 - position.moves) / 2;
+        if (alpha < lowest) {
+            alpha = lowest;
+            if (alpha >= beta) return alpha;
+        }
+        const int highest = static_cast<int>(cellCount - 1 - position.moves) / 2;
+        if (beta > highest) {
+            beta = highest;
+            if (alpha >= beta) return beta;
+        }
+
+        const std::uint64_t key = tableKey(position);
+        unsigned int tableMove = NO_MOVE;
+        if (std::optional<TranspositionEntry> entry = table.probe(key)) {
+            if (entry->bound == Bound::LOWER) {
+                if (alpha < entry->score) {
+                    alpha = entry->score;
+                    if (alpha >= beta) return alpha;
+                }
+                tableMove = entry->bestMove;
+            } else if (beta > entry->score) {
+                beta = entry->score;
+                if (alpha >= beta) return beta;
+            }
+        }
+
+        // the move that refuted this position before, then the moves creating the most threats, center first if equal
+        std::array<Move, MAX_WIDTH> sorted;
+        unsigned int moveCount = 0;
+        for (unsigned int column: columnOrder) {
+            const std::uint64_t cell = moves & columnMask(column);
+            if (!cell) continue;
+            int priority = column == tableMove ? static_cast<int>(cellCount)
+                                               : std::popcount(winningCells(position.current | cell, position.mask));
+            unsigned int i = moveCount++;
+            for (; i > 0 && sorted[i - 1].priority < priority; i--) {
+                sorted[i] = sorted[i - 1];
+            }
+            sorted[i] = {cell, priority, column};
+        }
+
+        // the children are probed one after the other, load their entries all at once
+        std::array<Position, MAX_WIDTH> children;
+        for (unsigned int i = 0; i < moveCount; i++) {
+            children[i] = {position.current ^ position.mask, position.mask | sorted[i].cell, position.moves + 1};
+            table.prefetch(tableKey(children[i]));
+        }
+
+        const unsigned int remaining = cellCount - position.moves;
+        for (unsigned int i = 0; i < moveCount; i++) {
+            const Position &child = children[i];
+            const int score = -negamax(child, -beta, -alpha);
+            if (score >= beta) {
+                table.store(key, score, remaining, Bound::LOWER, sorted[i].column);
+                return score;
+            }
+            if (score > alpha) alpha = score;
+        }
+        table.store(key, alpha, remaining, Bound::UPPER, NO_MOVE);
+        return alpha;
+    }
+
+    /**
+     * @return the exact score of the position
+     */
+    int solve(const Position &position) {
+        if (canWinNext(position)) return winScore(position.moves);
+        int lowest = -static_cast<int>(cellCount - position.moves) / 2;
+        int highest = winScore(position.moves + 1);
+        while (lowest < highest) {
+            // null window around the middle, but closer to 0 first, as most positions are close to a draw
+            int middle = lowest + (highest - lowest) / 2;
+            if (middle <= 0 && lowest / 2 < middle) middle = lowest / 2;
+            else if (middle >= 0 && highest / 2 > middle) middle = highest / 2;
+            int score = negamax(position, middle, middle + 1);
+            if (score <= middle) highest = score;
+            else lowest = score;
+        }
+        return lowest;
+    }
+
+    Position positionOf(const Power4Game &game) const {
+        if (game.getWidth() != width || game.getHeight() != height) {
+            throw std::invalid_argument("the solver is for " + std::to_string(width) + "x" + std::to_string(height)
+                                        + " boards");
+        }
+        if (game.hasWinner() || game.isDraw()) {
+            throw std::invalid_argument("the game is over");
+        }
+        const BitBoard &bitBoard = *game.getBitBoard();
+        const unsigned int moves = game.getMoveCount();
+        if (static_cast<unsigned int>(std::popcount(bitBoard.discs(0))) != (moves + 1) / 2) {
+            throw std::invalid_argument("the players must alternate, starting with the first one");
+        }
+        return {bitBoard.discs(moves % 2), bitBoard.occupied(), moves};
+    }
+
+public:
+    /**
+     * @param tableBytes the memory budget of the transposition table
+     * @throws std::invalid_argument if the board doesn't fit in a BitBoard
+     */
+    explicit Solver(unsigned int width = 7, unsigned int height = 6, std::size_t tableBytes = DEFAULT_TABLE_BYTES)
+            : width(width), height(height), cellCount(width * height), bottomMask(0), boardMask(0),
+              columnOrder(centerFirstColumns(width)), table(tableBytes, ReplacementPolicy::DEPTH_PREFERRED) {
+        if (width == 0 || height == 0 || !BitBoard::fits(width, height)) {
+            throw std::invalid_argument("the solver only works on boards of at most 64 cells including a row on top");
+        }
+        for (unsigned int x = 0; x < width; x++) {
+            bottomMask |= std::uint64_t{1} << (x * (height + 1));
+        }
+        boardMask = bottomMask * ((std::uint64_t{1} << height) - 1);
+    }
+
+    /**
+     * Finds the exact score of a game that is not over, for the player to play. The table is kept between calls, so
+     * solving positions of the same game goes faster and faster.
+     */
+    SolveResult solve(const Power4Game &game) {
+        const auto start = std::chrono::steady_clock::now();
+        const Position position = positionOf(game);
+        nodes = 0;
+        const int score = solve(position);
+        return {score, pliesToEnd(score, position.moves), nodes, std::chrono::steady_clock::now() - start};
+    }
+
+    /**
+     * @return the score of each column for the player to play (see SolveResult::score), nothing for full columns
+     */
+    std::vector<std::optional<int>> analyze(const Power4Game &game) {
+        const Position position = positionOf(game);
+        std::vector<std::optional<int>> scores(width);
+        const std::uint64_t playable = playableCells(position);
+        for (unsigned int column = 0; column < width; column++) {
+            const std::uint64_t cell = playable & columnMask(column);
+            if (!cell) continue;
+            if (winningCells(position.current, position.mask) & cell) {
+                scores[column] = winScore(position.moves);
+            } else if (position.moves + 1 == cellCount) {
+                scores[column] = 0;
+            } else {
+                scores[column] = -solve(Position{position.current ^ position.mask, position.mask | cell,
+                                                 position.moves + 1});
+            }
+        }
+        return scores;
+    }
+
+    /**
+     * @param moves the number of moves played in the position the score is for
+     * @return the number of moves left to play by both players until the end of the game, including the last one
+     */
+    [[nodiscard]] unsigned int pliesToEnd(int score, unsigned int moves) const {
+        if (score == 0) return cellCount - moves;
+        // the winner plays the n-th move from now, with moves + n - 1 discs already on the board
+        for (unsigned int n = score > 0 ? 1 : 2; moves + n <= cellCount; n += 2) {
+            if (winScore(moves + n - 1) == (score > 0 ? score : -score)) return n;
+        }
+        throw std::invalid_argument("no win has a score of " + std::to_string(score) + " after " + std::to_string(moves)
+                                    + " moves");
+    }
+
+    /**
+     * Forgets all the positions solved so far
+     */
+    void reset() {
+        table.clear();
+    }
+
+    [[nodiscard]] unsigned int getWidth() const {
+        return width;
+    }
+
+    [[nodiscard]] unsigned int getHeight() const {
+        return height;
+    }
+};
+
+
+#endif //POWER4_SOLVER_HPP
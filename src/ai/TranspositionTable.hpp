@@ -0,0 +1,230 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_TRANSPOSITIONTABLE_HPP
+#define POWER4_TRANSPOSITIONTABLE_HPP
+
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+enum class Bound : std::uint8_t {
+    NONE, // empty entry
+    EXACT,
+    LOWER, // the score is at least this
+    UPPER // the score is at most this
+};
+
+struct TranspositionEntry {
+    std::uint64_t key = 0;
+    std::int32_t score = 0;
+    std::uint8_t depth = 0;
+    Bound bound = Bound::NONE;
+    std::uint8_t bestMove = 0;
+    std::uint8_t generation = 0;
+};
+
+enum class ReplacementPolicy {
+    /**
+     * New entries always overwrite a slot of their bucket, chosen by their key
+     */
+    ALWAYS_REPLACE,
+    /**
+     * New entries overwrite the entry of their bucket left by the oldest search, then the shallowest one
+     */
+    DEPTH_PREFERRED
+};
+
+/**
+ * Counters of the use of a transposition table. They are kept by each search thread rather than by the table, so that
+ * threads don't fight over the same cache line.
+ */
+struct TranspositionStats {
+    std::uint64_t probes = 0;
+    std::uint64_t hits = 0; // probes that found their position
+    std::uint64_t stores = 0;
+    std::uint64_t overwrites = 0; // stores that evicted another position
+
+    [[nodiscard]] double hitRate() const {
+        return probes == 0 ? 0 : static_cast<double>(hits) / static_cast<double>(probes);
+    }
+
+    TranspositionStats &operator+=(const TranspositionStats &other) {
+        probes += other.probes;
+        hits += other.hits;
+        stores += other.stores;
+        overwrites += other.overwrites;
+        return *this;
+    }
+};
+
+/**
+ * Fixed-size hash table of searched positions. Entries are grouped in buckets of one cache line, so a probe reads a
+ * single cache line.
+ *
+ * The table can be shared by several search threads without locks: an entry is two 64-bit words, the packed data and
+ * the key xor-ed with the data. If two threads write the same entry at the same time and the words get mixed, the key
+ * read back doesn't match anymore and the entry is ignored.
+ */
+class TranspositionTable {
+public:
+    static constexpr std::size_t ENTRIES_PER_BUCKET = 4;
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> keyXorData{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    struct alignas(64) Bucket {
+        std::array<Slot, ENTRIES_PER_BUCKET> slots;
+    };
+    static_assert(sizeof(Bucket) == 64);
+
+    std::vector<Bucket> buckets;
+    std::uint64_t bucketMask;
+    ReplacementPolicy policy;
+    std::uint8_t generation = 0;
+
+    static std::uint64_t pack(const TranspositionEntry &entry) {
+        return static_cast<std::uint32_t>(entry.score)
+               | static_cast<std::uint64_t>(entry.depth) << 32
+               | static_cast<std::uint64_t>(entry.bound) << 40
+               | static_cast<std::uint64_t>(entry.bestMove) << 48
+               | static_cast<std::uint64_t>(entry.generation) << 56;
+    }
+
+    static TranspositionEntry unpack(std::uint64_t key, std::uint64_t data) {
+        return {key, static_cast<std::int32_t>(static_cast<std::uint32_t>(data)),
+                static_cast<std::uint8_t>(data >> 32), static_cast<Bound>(static_cast<std::uint8_t>(data >> 40)),
+                static_cast<std::uint8_t>(data >> 48), static_cast<std::uint8_t>(data >> 56)};
+    }
+
+    /**
+     * @return the entry of a slot, with a key of 0 if the slot was being written
+     */
+    static TranspositionEntry read(const Slot &slot) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t key = slot.keyXorData.load(std::memory_order_relaxed) ^ data;
+        return unpack(key, data);
+    }
+
+    Bucket &bucketOf(std::uint64_t key) {
+        // the low bits of the key choose the bucket, and its high bits the slot to replace in it (see victim), but
+        // the slots store the whole key, which is compared on each probe
+        return buckets[key & bucketMask];
+    }
+
+    Slot &victim(Bucket &bucket, std::uint64_t key) {
+        if (policy == ReplacementPolicy::ALWAYS_REPLACE) {
+            return bucket.slots[(key >> 62) % ENTRIES_PER_BUCKET];
+        }
+        Slot *victim = &bucket.slots[0];
+        TranspositionEntry victimEntry = read(*victim);
+        for (Slot &slot: bucket.slots) {
+            TranspositionEntry entry = read(slot);
+            if (entry.bound == Bound::NONE) return slot;
+            bool isOlder = entry.generation != generation && victimEntry.generation == generation;
+            bool isSameAge = (entry.generation == generation) == (victimEntry.generation == generation);
+            if (isOlder || (isSameAge && entry.depth < victimEntry.depth)) {
+                victim = &slot;
+                victimEntry = entry;
+            }
+        }
+        return *victim;
+    }
+
+public:
+    /**
+     * @param bytes the memory budget, rounded down to a power of two number of buckets
+     */
+    explicit TranspositionTable(std::size_t bytes, ReplacementPolicy policy = ReplacementPolicy::DEPTH_PREFERRED)
+            : buckets(std::bit_floor(bytes / sizeof(Bucket))), bucketMask(buckets.size() - 1), policy(policy) {
+        if (buckets.empty()) {
+            throw std::invalid_argument("transposition table too small, it needs at least 64 bytes");
+        }
+    }
+
+    /**
+     * Looks for a position. Thread-safe.
+     */
+    std::optional<TranspositionEntry> probe(std::uint64_t key) {
+        for (const Slot &slot: bucketOf(key).slots) {
+            TranspositionEntry entry = read(slot);
+            if (entry.key == key && entry.bound != Bound::NONE) {
+                return entry;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * Starts loading the bucket of a position into the cache, to probe it a bit later without waiting for the memory
+     */
+    void prefetch(std::uint64_t key) const {
+        __builtin_prefetch(&buckets[key & bucketMask]);
+    }
+
+    /**
+     * Stores a position. Thread-safe.
+     * @return true if another position was evicted
+     */
+    bool store(std::uint64_t key, std::int32_t score, unsigned int depth, Bound bound, unsigned int bestMove) {
+        Bucket &bucket = bucketOf(key);
+        Slot *target = nullptr;
+        bool evicted = false;
+        for (Slot &slot: bucket.slots) {
+            TranspositionEntry entry = read(slot);
+            if (entry.key == key && entry.bound != Bound::NONE) {
+                target = &slot;
+                break;
+            }
+        }
+        if (target == nullptr) {
+            target = &victim(bucket, key);
+            evicted = read(*target).bound != Bound::NONE;
+        }
+        std::uint64_t data = pack({key, score, static_cast<std::uint8_t>(depth), bound,
+                                   static_cast<std::uint8_t>(bestMove), generation});
+        target->keyXorData.store(key ^ data, std::memory_order_relaxed);
+        target->data.store(data, std::memory_order_relaxed);
+        return evicted;
+    }
+
+    /**
+     * Marks the entries stored so far as coming from a previous search, so that they are replaced first. Must not be
+     * called while searching.
+     */
+    void newSearch() {
+        generation++;
+    }
+
+    /**
+     * Empties the table. Must not be called while searching.
+     */
+    void clear() {
+        for (Bucket &bucket: buckets) {
+            for (Slot &slot: bucket.slots) {
+                slot.keyXorData.store(0, std::memory_order_relaxed);
+                slot.data.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t getCapacity() const {
+        return buckets.size() * ENTRIES_PER_BUCKET;
+    }
+
+    [[nodiscard]] std::size_t getBytes() const {
+        return buckets.size() * sizeof(Bucket);
+    }
+};
+
+
+#endif //POWER4_TRANSPOSITIONTABLE_HPP
@@ -0,0 +1,307 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_BATCHANALYSIS_HPP
+#define POWER4_BATCHANALYSIS_HPP
+
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../ai/AlphaBetaSearch.hpp"
+
+struct BatchOptions {
+    unsigned int threads = 0; // 0 for one per hardware thread
+    unsigned int depth = 0; // of the AlphaBetaSearch of each position, 0 to only use getScore
+    /**
+     * Size of the transposition table of each thread, cleared before each position
+     */
+    std::size_t tableBytes = 1 << 20;
+    /**
+     * Maximum number of positions read but not written yet: the memory used only depends on it, not on the number of
+     * positions
+     */
+    std::size_t window = 1024;
+    unsigned int width = 7, height = 6;
+};
+
+/**
+ * Counts of durations in buckets growing exponentially, 16 per power of 2, so that percentiles are known within about
+ * 6% with a fixed amount of memory whatever the number of durations.
+ */
+class LatencyHistogram {
+private:
+    static constexpr unsigned int SUB_BUCKETS = 16;
+    std::array<std::uint64_t, 64 * SUB_BUCKETS> counts{};
+    std::uint64_t count = 0;
+    std::chrono::nanoseconds max{0};
+
+    static unsigned int bucketOf(std::uint64_t nanoseconds) {
+        const unsigned int magnitude = std::bit_width(nanoseconds);
+        if (magnitude <= 4) return static_cast<unsigned int>(nanoseconds);
+        // the 4 bits after the highest one
+        return magnitude * SUB_BUCKETS + static_cast<unsigned int>(nanoseconds >> (magnitude - 5) & (SUB_BUCKETS - 1));
+    }
+
+    /**
+     * @return the largest duration of a bucket
+     */
+    static std::uint64_t upperBound(unsigned int bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        const unsigned int magnitude = bucket / SUB_BUCKETS;
+        const std::uint64_t base = (std::uint64_t{SUB_BUCKETS} | bucket % SUB_BUCKETS) << (magnitude - 5);
+        return base + (std::uint64_t{1} << (magnitude - 5)) - 1;
+    }
+
+public:
+    void add(std::chrono::nanoseconds duration) {
+        counts[bucketOf(static_cast<std::uint64_t>(duration.count()))]++;
+        count++;
+        if (duration > max) max = duration;
+    }
+
+    LatencyHistogram &operator+=(const LatencyHistogram &other) {
+        for (std::size_t i = 0; i < counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        count += other.count;
+        if (other.max > max) max = other.max;
+        return *this;
+    }
+
+    [[nodiscard]] std::uint64_t getCount() const {
+        return count;
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds getMax() const {
+        return max;
+    }
+
+    /**
+     * @param percent between 0 and 100
+     * @return a duration that at least percent % of the durations don't exceed, 0 if there are none
+     */
+    [[nodiscard]] std::chrono::nanoseconds percentile(double percent) const {
+        if (count == 0) return std::chrono::nanoseconds::zero();
+        auto rank = static_cast<std::uint64_t>(std::ceil(percent / 100 * static_cast<double>(count)));
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (unsigned int bucket = 0; bucket < counts.size(); bucket++) {
+            seen += counts[bucket];
+            if (seen >= rank) {
+                const auto bound = std::chrono::nanoseconds(static_cast<std::int64_t>(upperBound(bucket)));
+                return bound < max ? bound : max;
+            }
+        }
+        return max;
+    }
+};
+
+struct BatchStats {
+    std::uint64_t positions = 0;
+    std::uint64_t invalid = 0; // positions that couldn't be played, or already over
+    std::chrono::nanoseconds elapsed{0};
+    LatencyHistogram latencies; // of the evaluation of each valid position, without the time waiting in the queue
+
+    [[nodiscard]] double positionsPerSecond() const {
+        return elapsed.count() == 0 ? 0 : static_cast<double>(positions) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * Evaluates positions on a pool of threads, and writes one line per position in the order they were added:
+ * - "moves score" with the score of getScore for the player to move, if BatchOptions::depth is 0
+ * - "moves score column" with the score of an AlphaBetaSearch and the best column (numbered from 1) otherwise
+ * - "moves invalid" or "moves over" if the moves can't be played, or if the game is over
+ *
+ * add blocks while BatchOptions::window positions wait to be written, so that the positions can be streamed.
+ */
+class BatchAnalyzer {
+private:
+    struct Job {
+        std::uint64_t index;
+        std::string moves;
+        std::vector<std::uint8_t> columns;
+        bool valid;
+    };
+
+    struct Slot {
+        bool done = false;
+        std::string line;
+    };
+
+    std::ostream &out;
+    BatchOptions options;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::mutex mutex;
+    std::condition_variable jobAdded, slotFreed;
+    std::deque<Job> jobs;
+    std::vector<Slot> slots; // the lines of the positions from nextToWrite, by index % window
+    std::uint64_t added = 0, nextToWrite = 0, invalid = 0;
+    bool finishing = false;
+    std::exception_ptr error;
+
+    std::vector<LatencyHistogram> threadLatencies;
+    std::vector<std::thread> threads;
+
+    /**
+     * @return the line of a position, and adds its latency if it is valid
+     */
+    std::string evaluate(Job &job, Power4Game &game, AlphaBetaSearch *search, LatencyHistogram &latencies,
+                         bool &isInvalid) {
+        const auto evaluationStart = std::chrono::steady_clock::now();
+        isInvalid = true;
+        if (!job.valid || !game.addInColumns(job.columns)) return job.moves + " invalid";
+        if (game.hasWinner() || game.isDraw()) return job.moves + " over";
+        isInvalid = false;
+        const Power4Player player = game.getMoveCount() % 2 == 0 ? '1' : '2';
+        std::string line;
+        if (search == nullptr) {
+            line = std::format("{} {:.1f}", job.moves, game.getScore(player) + 0.0); // no -0.0
+        } else {
+            // nothing is kept from the positions before, so that the result doesn't depend on the threads
+            search->getTranspositionTable().clear();
+            const SearchResult result = search->search(game, player);
+            line = std::format("{} {} {}", job.moves, result.score, result.column + 1);
+        }
+        latencies.add(std::chrono::steady_clock::now() - evaluationStart);
+        return line;
+    }
+
+    void work(unsigned int index) {
+        try {
+            std::unique_ptr<AlphaBetaSearch> search;
+            if (options.depth != 0) {
+                search = std::make_unique<AlphaBetaSearch>(options.depth, options.tableBytes);
+                search->setThreadCount(1);
+            }
+            const Power4Game emptyBoard(static_cast<int>(options.width), static_cast<int>(options.height));
+            Power4Game game = emptyBoard;
+            while (true) {
+                Job job;
+                {
+                    std::unique_lock lock(mutex);
+                    jobAdded.wait(lock, [&] { return !jobs.empty() || finishing; });
+                    if (jobs.empty()) return;
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+                game = emptyBoard;
+                bool isInvalid;
+                std::string line = evaluate(job, game, search.get(), threadLatencies[index], isInvalid);
+
+                std::lock_guard lock(mutex);
+                if (isInvalid) invalid++;
+                slots[job.index % slots.size()] = {true, std::move(line)};
+                bool wrote = false;
+                for (Slot *slot = &slots[nextToWrite % slots.size()]; slot->done;
+                     slot = &slots[nextToWrite % slots.size()]) {
+                    out << slot->line << '\n';
+                    *slot = {};
+                    nextToWrite++;
+                    wrote = true;
+                }
+                if (wrote) slotFreed.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            if (!error) error = std::current_exception();
+            finishing = true;
+            jobAdded.notify_all();
+            slotFreed.notify_all();
+        }
+    }
+
+public:
+    /**
+     * @throws std::invalid_argument if the window is empty or the board size is invalid
+     */
+    BatchAnalyzer(std::ostream &out, const BatchOptions &options) : out(out), options(options) {
+        if (options.window == 0) throw std::invalid_argument("the window must hold at least one position");
+        Power4Game(static_cast<int>(options.width), static_cast<int>(options.height)); // checks the size
+        slots.resize(options.window);
+        unsigned int threadCount = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+        threadLatencies.resize(threadCount);
+        threads.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; i++) {
+            threads.emplace_back(&BatchAnalyzer::work, this, i);
+        }
+    }
+
+    BatchAnalyzer(const BatchAnalyzer &) = delete;
+
+    BatchAnalyzer &operator=(const BatchAnalyzer &) = delete;
+
+    ~BatchAnalyzer() {
+        {
+            std::lock_guard lock(mutex);
+            finishing = true;
+        }
+        jobAdded.notify_all();
+        for (std::thread &thread: threads) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    /**
+     * Adds a position, waiting if the window is full
+     * @param moves written at the start of its line
+     * @param columns the moves from the empty board, the players alternating
+     * @param valid false if the moves couldn't even be read, to write "invalid" in its turn
+     * @throws the exception of a thread that failed
+     */
+    void add(std::string moves, std::vector<std::uint8_t> columns, bool valid = true) {
+        std::unique_lock lock(mutex);
+        slotFreed.wait(lock, [&] { return added - nextToWrite < slots.size() || error; });
+        if (error) std::rethrow_exception(error);
+        jobs.push_back({added++, std::move(moves), std::move(columns), valid});
+        lock.unlock();
+        jobAdded.notify_one();
+    }
+
+    /**
+     * Waits for all the positions to be written
+     * @throws the exception of a thread that failed
+     */
+    BatchStats finish() {
+        {
+            std::lock_guard lock(mutex);
+            finishing = true;
+        }
+        jobAdded.notify_all();
+        for (std::thread &thread: threads) {
+            thread.join();
+        }
+        if (error) std::rethrow_exception(error);
+        out.flush();
+
+        BatchStats stats;
+        stats.positions = added;
+        stats.invalid = invalid;
+        stats.elapsed = std::chrono::steady_clock::now() - start;
+        for (const LatencyHistogram &latencies: threadLatencies) {
+            stats.latencies += latencies;
+        }
+        return stats;
+    }
+};
+
+
+#endif //POWER4_BATCHANALYSIS_HPP
@@ -0,0 +1,135 @@
+#include <array>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "BatchAnalysis.hpp"
+#include "../record/GameRecord.hpp"
+
+/**
+ * @return true if the file starts like a GameRecordWriter record
+ */
+bool isRecord(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    std::array<char, 4> magic{};
+    return in.read(magic.data(), magic.size()) && magic == GameRecordWriter::MAGIC;
+}
+
+/**
+ * Adds the positions of a text file, one per line in the column string notation (see toColumnString), the other
+ * fields of the line being ignored
+ */
+void addLines(std::istream &in, BatchAnalyzer &analyzer, unsigned int width) {
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string moves;
+        if (!(fields >> moves) || moves[0] == '#') continue;
+        try {
+            std::vector<std::uint8_t> columns = parseColumnString(moves, width);
+            analyzer.add(std::move(moves), std::move(columns));
+        } catch (const std::invalid_argument &) {
+            analyzer.add(std::move(moves), {}, false);
+        }
+    }
+}
+
+double toMicroseconds(std::chrono::nanoseconds duration) {
+    return static_cast<double>(duration.count()) / 1e3;
+}
+
+/**
+ * Usage: Power4Analyze [--depth n] [--threads n] [--table-mb n] [--window n] [--size WxH] [--output file] [input]
+ *
+ * Evaluates positions given one per line in the column string notation (like "4453", or "-" for the empty board), or
+ * the games of a record (see GameRecord.hpp, whose board size is used), read from a file or stdin if there is none or
+ * it is -. Writes to stdout or the output file one line per position in the same order, see BatchAnalyzer, and the
+ * throughput and the percentiles of the time spent on each position to stderr.
+ *
+ * Without --depth the score is the one of getScore for the player to move, otherwise the one of an AlphaBetaSearch
+ * of that depth, followed by the best column. --table-mb is the size of the transposition table of each thread (1 by
+ * default, cleared before each position, so that the output doesn't depend on --threads), and --window the number of
+ * positions read ahead of the output.
+ */
+int main(int argc, char *argv[]) {
+    try {
+        BatchOptions options;
+        std::string input = "-", output;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) {
+                input = arg;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value after " << arg << std::endl;
+                return 2;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--depth") options.depth = std::stoul(value);
+            else if (arg == "--threads") options.threads = std::stoul(value);
+            else if (arg == "--table-mb") options.tableBytes = std::stoull(value) << 20;
+            else if (arg == "--window") options.window = std::stoull(value);
+            else if (arg == "--output") output = value;
+            else if (arg == "--size") {
+                const std::size_t x = value.find('x');
+                if (x == std::string::npos) throw std::invalid_argument("the size must look like 7x6");
+                options.width = std::stoul(value.substr(0, x));
+                options.height = std::stoul(value.substr(x + 1));
+            } else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return 2;
+            }
+        }
+
+        std::unique_ptr<GameRecordReader> record;
+        if (input != "-" && isRecord(input)) {
+            record = std::make_unique<GameRecordReader>(input);
+            options.width = record->getWidth();
+            options.height = record->getHeight();
+        }
+        std::ofstream file;
+        if (!output.empty()) {
+            file.open(output);
+            if (!file) throw std::runtime_error("cannot open " + output);
+        }
+        std::ostream &out = output.empty() ? std::cout : file;
+
+        BatchAnalyzer analyzer(out, options);
+        if (record) {
+            record->forEachGame([&](const RecordedGame &game) {
+                std::vector<std::uint8_t> columns = game.getColumns();
+                std::string moves = toColumnString(columns);
+                analyzer.add(std::move(moves), std::move(columns));
+            });
+        } else if (input == "-") {
+            addLines(std::cin, analyzer, options.width);
+        } else {
+            std::ifstream in(input);
+            if (!in) throw std::runtime_error("cannot open " + input);
+            addLines(in, analyzer, options.width);
+        }
+        const BatchStats stats = analyzer.finish();
+        if (!out) throw std::runtime_error("cannot write the results");
+
+        std::cerr << std::format("{} positions ({} invalid or over) in {:.1f} ms, {:.0f} positions/s", stats.positions,
+                                 stats.invalid, static_cast<double>(stats.elapsed.count()) / 1e6,
+                                 stats.positionsPerSecond()) << std::endl;
+        std::cerr << std::format("latency us: p50 {:.1f} p90 {:.1f} p99 {:.1f} p99.9 {:.1f} max {:.1f}",
+                                 toMicroseconds(stats.latencies.percentile(50)),
+                                 toMicroseconds(stats.latencies.percentile(90)),
+                                 toMicroseconds(stats.latencies.percentile(99)),
+                                 toMicroseconds(stats.latencies.percentile(99.9)),
+                                 toMicroseconds(stats.latencies.getMax())) << std::endl;
+        return 0;
+    } catch (const TracedException &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        e.printTrace();
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
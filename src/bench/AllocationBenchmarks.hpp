@@ -0,0 +1,62 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_ALLOCATIONBENCHMARKS_HPP
+#define POWER4_ALLOCATIONBENCHMARKS_HPP
+
+
+#include <format>
+#include <iostream>
+#include <string>
+#include "AllocationCounter.hpp"
+#include "BoardBenchmarks.hpp"
+#include "../ai/MonteCarloSearch.hpp"
+
+/**
+ * Global heap allocations of Monte Carlo searches of different sizes: as the search loop doesn't allocate, they are the
+ * same whatever the number of playouts. The tree goes to the arena instead.
+ */
+inline void runAllocationBenchmarks() {
+    const AllocationCounting counting;
+    for (std::uint64_t playouts: {10000u, 100000u, 1000000u}) {
+        MonteCarloSearch search(playouts);
+        const std::uint64_t before = globalAllocations();
+        const SearchResult result = search.search(Power4Game(), '1');
+        const std::uint64_t allocations = globalAllocations() - before;
+        std::cout << std::format("{:<40} {:>8} global allocations {:>10} arena allocations {:>8.1f} MiB tree "
+                                 "{:>10.0f} playouts/s",
+                                 std::format("mcts {} playouts", playouts), allocations,
+                                 search.getTreeAllocations(), static_cast<double>(search.getTreeBytes()) / (1 << 20),
+                                 result.nodesPerSecond())
+                  << std::endl;
+    }
+
+    // a game where the tree is kept from one move to the next
+    MonteCarloSearch search(100000);
+    Power4Game game;
+    std::uint64_t allocations = 0;
+    unsigned int moves = 0;
+    while (!game.hasWinner() && !game.isDraw()) {
+        const Power4Player player = game.getMoveCount() % 2 == 0 ? '1' : '2';
+        const std::uint64_t before = globalAllocations();
+        const unsigned int column = search.search(game, player).column;
+        allocations += globalAllocations() - before;
+        game.addInColumn(column, player);
+        moves++;
+    }
+    std::cout << std::format("{:<40} {:>8.1f} global allocations per move", "mcts 100000 playouts, whole game",
+                             static_cast<double>(allocations) / moves) << std::endl;
+
+    const std::vector<Power4Game> positions = randomPositions(7, 6, 1000);
+    const std::uint64_t before = globalAllocations();
+    for (const Power4Game &position: positions) {
+        Power4Game copy = position;
+        doNotOptimize(copy);
+    }
+    std::cout << std::format("{:<40} {:>8.1f} global allocations per copy", "copy Power4Game 7x6",
+                             static_cast<double>(globalAllocations() - before) / positions.size()) << std::endl;
+}
+
+
+#endif //POWER4_ALLOCATIONBENCHMARKS_HPP
@@ -0,0 +1,124 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_ALLOCATIONCOUNTER_HPP
+#define POWER4_ALLOCATIONCOUNTER_HPP
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replaces the global operator new to count the heap allocations of the whole program while an AllocationCounting
+ * exists. This header defines the replacements, so it must only be included by one file of an executable, its main
+ * file.
+ */
+inline std::atomic<std::uint64_t> globalAllocationCount = 0;
+/**
+ * Outside of an AllocationCounting, operator new only reads this, so that the other benchmarks don't pay for an atomic
+ * increment on each allocation
+ */
+inline std::atomic<bool> allocationCountingEnabled = false;
+
+/**
+ * Counts the allocations of all threads while it exists
+ */
+class AllocationCounting {
+public:
+    AllocationCounting() {
+        allocationCountingEnabled.store(true, std::memory_order_relaxed);
+    }
+
+    AllocationCounting(const AllocationCounting &) = delete;
+
+    AllocationCounting &operator=(const AllocationCounting &) = delete;
+
+    ~AllocationCounting() {
+        allocationCountingEnabled.store(false, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @return the number of calls to the global operator new so far, from all threads, while an AllocationCounting existed
+ */
+inline std::uint64_t globalAllocations() {
+    return globalAllocationCount.load(std::memory_order_relaxed);
+}
+
+inline void countAllocation() {
+    if (allocationCountingEnabled.load(std::memory_order_relaxed)) {
+        globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void *operator new(std::size_t size) {
+    countAllocation();
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+    countAllocation();
+    const auto alignment = static_cast<std::size_t>(align);
+    // aligned_alloc needs a size that is a multiple of the alignment
+    const std::size_t rounded = ((size == 0 ? 1 : size) + alignment - 1) / alignment * alignment;
+    if (void *memory = std::aligned_alloc(alignment, rounded)) return memory;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+// GCC doesn't know that these operators replace the ones of the library, and warns that free is called on memory from
+// operator new when they are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+
+#endif //POWER4_ALLOCATIONCOUNTER_HPP
@@ -0,0 +1,158 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_BENCHMARK_HPP
+#define POWER4_BENCHMARK_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include <format>
+#include <vector>
+
+/**
+ * How long the benchmarks run, the same for all of them
+ */
+struct BenchmarkSettings {
+    std::chrono::nanoseconds warmup = std::chrono::milliseconds(100); // run before measuring, not counted
+    unsigned int repetitions = 5; // number of samples
+    std::chrono::nanoseconds sampleDuration = std::chrono::milliseconds(100); // minimum duration of each sample
+};
+
+inline BenchmarkSettings benchmarkSettings;
+
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t ops;
+    std::chrono::nanoseconds elapsed; // of all the samples
+    std::vector<double> samples; // ns/op of each repetition, sorted
+
+    /**
+     * @param percent between 0 and 100, interpolating between the two closest samples
+     */
+    [[nodiscard]] double percentile(double percent) const {
+        if (samples.empty()) return 0;
+        const double rank = percent / 100 * static_cast<double>(samples.size() - 1);
+        const auto below = static_cast<std::size_t>(std::floor(rank));
+        const std::size_t above = below + 1 < samples.size() ? below + 1 : below;
+        return samples[below] + (samples[above] - samples[below]) * (rank - static_cast<double>(below));
+    }
+
+    /**
+     * @return the median of the samples, less sensitive to the noise of other processes than the mean
+     */
+    [[nodiscard]] double nsPerOp() const {
+        return percentile(50);
+    }
+
+    [[nodiscard]] double opsPerSecond() const {
+        return 1e9 / nsPerOp();
+    }
+};
+
+/**
+ * Prevents the compiler from optimizing away a value computed in a benchmark
+ */
+template<typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Runs a benchmark for benchmarkSettings.warmup, then measures benchmarkSettings.repetitions samples.
+ * @param body a function running the benchmarked operation some times, and returning how many times it did
+ */
+template<typename F>
+BenchmarkResult runBenchmark(const std::string &name, F &&body) {
+    using clock = std::chrono::steady_clock;
+    const auto warmupStart = clock::now();
+    while (clock::now() - warmupStart < benchmarkSettings.warmup) {
+        body();
+    }
+
+    BenchmarkResult result{name, 0, std::chrono::nanoseconds::zero(), {}};
+    for (unsigned int i = 0; i < benchmarkSettings.repetitions; i++) {
+        std::uint64_t ops = 0;
+        const auto start = clock::now();
+        auto elapsed = clock::duration::zero();
+        while (elapsed < benchmarkSettings.sampleDuration) {
+            ops += body();
+            elapsed = clock::now() - start;
+        }
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+        result.ops += ops;
+        result.elapsed += nanoseconds;
+        result.samples.push_back(static_cast<double>(nanoseconds.count()) / static_cast<double>(ops));
+    }
+    std::sort(result.samples.begin(), result.samples.end());
+    return result;
+}
+
+/**
+ * @return the results printed so far, see writeJson
+ */
+inline std::vector<BenchmarkResult> &printedResults() {
+    static std::vector<BenchmarkResult> results;
+    return results;
+}
+
+inline void printResult(const BenchmarkResult &result) {
+    std::cout << std::format("{:<40} {:>12.1f} ns/op {:>14.0f} ops/s   p10 {:>10.1f} p90 {:>10.1f}", result.name,
+                             result.nsPerOp(), result.opsPerSecond(), result.percentile(10), result.percentile(90))
+              << std::endl;
+    printedResults().push_back(result);
+}
+
+inline std::string jsonString(const std::string &value) {
+    std::string escaped = "\"";
+    for (char c: value) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + '"';
+}
+
+/**
+ * Writes the printed results as JSON, to compare them between versions: an object with the settings and the build in
+ * "context", and the results in "benchmarks", times in ns/op.
+ */
+inline void writeJson(std::ostream &out) {
+    out << "{\n  \"context\": {\n";
+#ifdef __VERSION__
+    out << "    \"compiler\": " << jsonString(__VERSION__) << ",\n";
+#endif
+#ifdef NDEBUG
+    out << "    \"assertions\": false,\n";
+#else
+    out << "    \"assertions\": true,\n";
+#endif
+    out << std::format("    \"warmup_ms\": {},\n    \"repetitions\": {},\n    \"sample_ms\": {}\n  }},\n",
+                       std::chrono::duration_cast<std::chrono::milliseconds>(benchmarkSettings.warmup).count(),
+                       benchmarkSettings.repetitions,
+                       std::chrono::duration_cast<std::chrono::milliseconds>(benchmarkSettings.sampleDuration).count());
+    out << "  \"benchmarks\": [";
+    const std::vector<BenchmarkResult> &results = printedResults();
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult &result = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << std::format("    {{\"name\": {}, \"ops\": {}, \"ns_per_op\": {:.3f}, \"ops_per_second\": {:.1f}, "
+                           "\"min\": {:.3f}, \"p10\": {:.3f}, \"p50\": {:.3f}, \"p90\": {:.3f}, \"max\": {:.3f}, "
+                           "\"samples\": [",
+                           jsonString(result.name), result.ops, result.nsPerOp(), result.opsPerSecond(),
+                           result.percentile(0), result.percentile(10), result.percentile(50),
+                           result.percentile(90), result.percentile(100));
+        for (std::size_t j = 0; j < result.samples.size(); j++) {
+            out << std::format("{}{:.3f}", j == 0 ? "" : ", ", result.samples[j]);
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}" << std::endl;
+}
+
+
+#endif //POWER4_BENCHMARK_HPP
@@ -0,0 +1,334 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_BOARDBENCHMARKS_HPP
+#define POWER4_BOARDBENCHMARKS_HPP
+
+
+#include <random>
+#include <vector>
+#include "Benchmark.hpp"
+#include "../game/Power4Game.hpp"
+#include "../game/Power4Position.hpp"
+
+/**
+ * Plays random moves until the game is over or until maxMoves moves were played
+ * @return the number of moves played
+ */
+inline unsigned int playRandomMoves(Power4Game &game, std::mt19937 &random, unsigned int maxMoves = -1) {
+    Power4Player player = '1';
+    unsigned int moves = 0;
+    while (moves < maxMoves && !game.isDraw() && !game.hasWinner()) {
+        if (game.addInColumn(random() % game.getWidth(), player)) {
+            player = player == '1' ? '2' : '1';
+            moves++;
+        }
+    }
+    return moves;
+}
+
+/**
+ * @return deterministic random positions of a given size, with no winner
+ */
+inline std::vector<Power4Game> randomPositions(unsigned int width, unsigned int height, unsigned int count) {
+    std::mt19937 random(count);
+    std::vector<Power4Game> positions;
+    positions.reserve(count);
+    while (positions.size() < count) {
+        Power4Game game(static_cast<int>(width), static_cast<int>(height));
+        playRandomMoves(game, random, random() % (width * height / 2));
+        if (!game.hasWinner()) {
+            positions.push_back(game);
+        }
+    }
+    return positions;
+}
+
+inline void runBoardBenchmarks(unsigned int width, unsigned int height) {
+    const std::string size = std::format("{}x{}", width, height);
+
+    std::mt19937 random(42);
+    printResult(runBenchmark("random game moves " + size, [&] {
+        Power4Game game(static_cast<int>(width), static_cast<int>(height));
+        return playRandomMoves(game, random);
+    }));
+
+    const std::vector<Power4Game> positions = randomPositions(width, height, 1000);
+    printResult(runBenchmark("copy " + size, [&] {
+        for (const Power4Game &position: positions) {
+            Power4Game copy = position;
+            doNotOptimize(copy);
+        }
+        return positions.size();
+    }));
+
+    std::vector<Power4Game> playable = positions;
+    printResult(runBenchmark("addInColumn and undo " + size, [&] {
+        unsigned long moves = 0;
+        for (Power4Game &position: playable) {
+            const Power4Player player = position.getMoveCount() % 2 == 0 ? '1' : '2';
+            for (unsigned int column = 0; column < width; column++) {
+                if (!position.addInColumn(column, player)) continue;
+                position.undo();
+                moves++;
+            }
+        }
+        return moves;
+    }));
+
+    printResult(runBenchmark("isDraw " + size, [&] {
+        for (const Power4Game &position: positions) {
+            doNotOptimize(position.isDraw());
+        }
+        return positions.size();
+    }));
+
+    printResult(runBenchmark("count " + size, [&] {
+        for (const Power4Game &position: positions) {
+            doNotOptimize(position.count(Power4Player{'1'}));
+        }
+        return positions.size();
+    }));
+
+    printResult(runBenchmark("count predicate " + size, [&] {
+        for (const Power4Game &position: positions) {
+            doNotOptimize(position.count([](Power4Player value) { return value == '0'; }));
+        }
+        return positions.size();
+    }));
+
+    printResult(runBenchmark("getWinner " + size, [&] {
+        for (const Power4Game &position: positions) {
+            Power4Game copy = position;
+            copy.addInColumn(0, '1'); // clears the cache of the winner
+            doNotOptimize(copy.getWinner());
+        }
+        return positions.size();
+    }));
+
+    // on finished games, mostly won, and without the copy, to compare the allocating queries with the allocation-free
+    // ones
+    std::vector<Power4Game> finished;
+    for (unsigned int i = 0; i < 1000; i++) {
+        finished.emplace_back(static_cast<int>(width), static_cast<int>(height));
+        playRandomMoves(finished.back(), random);
+    }
+    printResult(runBenchmark("getWinner finished " + size, [&] {
+        for (const Power4Game &position: finished) {
+            doNotOptimize(position.getWinner());
+        }
+        return finished.size();
+    }));
+
+    printResult(runBenchmark("getOptionalWinner " + size, [&] {
+        for (const Power4Game &position: finished) {
+            doNotOptimize(position.getOptionalWinner());
+        }
+        return finished.size();
+    }));
+
+    printResult(runBenchmark("getWinnerCoords " + size, [&] {
+        for (const Power4Game &position: finished) {
+            doNotOptimize(position.getWinnerCoords());
+        }
+        return finished.size();
+    }));
+
+    printResult(runBenchmark("getWinningCells " + size, [&] {
+        for (const Power4Game &position: finished) {
+            doNotOptimize(position.getWinningCells());
+        }
+        return finished.size();
+    }));
+
+    printResult(runBenchmark("getScore " + size, [&] {
+        for (const Power4Game &position: positions) {
+            doNotOptimize(position.getScore('1'));
+        }
+        return positions.size();
+    }));
+
+    if (!BitBoard::fits(width, height)) return;
+
+    // what analysis threads sharing a game can do instead of copying it
+    printResult(runBenchmark("snapshot " + size, [&] {
+        for (const Power4Game &position: positions) {
+            doNotOptimize(Power4Position(position));
+        }
+        return positions.size();
+    }));
+
+    std::vector<Power4Position> snapshots(positions.begin(), positions.end());
+    printResult(runBenchmark("snapshot afterMove " + size, [&] {
+        unsigned long moves = 0;
+        for (const Power4Position &position: snapshots) {
+            for (unsigned int column = 0; column < width; column++) {
+                doNotOptimize(position.afterMove(column, '1'));
+                moves++;
+            }
+        }
+        return moves;
+    }));
+
+    printResult(runBenchmark("snapshot getScore " + size, [&] {
+        for (const Power4Position &position: snapshots) {
+            doNotOptimize(position.getScore('1'));
+        }
+        return snapshots.size();
+    }));
+}
+
+/**
+ * Compares the code specialized for a board size with the generic one, on moves (which update the score) and on
+ * moves that win (which also look for the winning line)
+ */
+inline void runSizeBenchmarks(unsigned int width, unsigned int height) {
+    std::mt19937 random(42);
+    for (bool specialized: {true, false}) {
+        const std::string name = std::format("{}x{} {}", width, height, specialized ? "specialized" : "generic");
+
+        std::vector<Power4Game> positions;
+        std::vector<std::pair<Power4Game, unsigned int>> beforeWins; // positions and the column that wins
+        while (beforeWins.size() < 1000) {
+            Power4Game game(static_cast<int>(width), static_cast<int>(height), specialized);
+            Power4Player player = '1';
+            while (!game.isDraw() && !game.hasWinner()) {
+                unsigned int column = random() % width;
+                if (!game.addInColumn(column, player)) continue;
+                if (game.hasWinner()) {
+                    game.undo();
+                    beforeWins.emplace_back(game, column);
+                    break;
+                }
+                if (positions.size() < 1000) positions.push_back(game);
+                player = player == '1' ? '2' : '1';
+            }
+        }
+
+        printResult(runBenchmark("play and undo " + name, [&] {
+            unsigned long moves = 0;
+            for (Power4Game &position: positions) {
+                for (unsigned int column = 0; column < width; column++) {
+                    if (!position.addInColumn(column, '1')) continue;
+                    doNotOptimize(position.getScore('1'));
+                    position.undo();
+                    moves++;
+                }
+            }
+            return moves;
+        }));
+
+        printResult(runBenchmark("winning move and undo " + name, [&] {
+            for (auto &[position, column]: beforeWins) {
+                position.addInColumn(column, position.getMoveCount() % 2 == 0 ? '1' : '2');
+                doNotOptimize(position.getOptionalWinner());
+                position.undo();
+            }
+            return beforeWins.size();
+        }));
+    }
+}
+
+/**
+ * Measures a move with its win check and score, then its undo, as the area of the board grows, across the boards
+ * stored in a BitBoard, a WideBitBoard or cells
+ */
+inline void runScalingBenchmarks(unsigned int width, unsigned int height) {
+    const std::string name = std::format("{}x{} ({} cells)", width, height, width * height);
+    std::vector<Power4Game> positions = randomPositions(width, height, 1000);
+    printResult(runBenchmark("move and undo " + name, [&] {
+        unsigned long moves = 0;
+        for (Power4Game &position: positions) {
+            const Power4Player player = position.getMoveCount() % 2 == 0 ? '1' : '2';
+            for (unsigned int column = 0; column < width; column++) {
+                if (!position.addInColumn(column, player)) continue;
+                doNotOptimize(position.hasWinner());
+                doNotOptimize(position.getScore(player));
+                position.undo();
+                moves++;
+            }
+        }
+        return moves;
+    }));
+
+    std::mt19937 random(42);
+    printResult(runBenchmark("random game moves " + name, [&] {
+        Power4Game game(static_cast<int>(width), static_cast<int>(height));
+        return playRandomMoves(game, random);
+    }));
+}
+
+/**
+ * Compares the versions of countBitBoardAlignments with the scan of the whole board done by computeScore
+ */
+inline void runEvalBenchmarks(unsigned int width, unsigned int height) {
+    const std::string size = std::format("{}x{}", width, height);
+    const std::vector<Power4Game> positions = randomPositions(width, height, 1000);
+    std::vector<BitBoard> bitBoards;
+    for (const Power4Game &position: positions) {
+        BitBoard bitBoard(width, height);
+        for (unsigned int x = 0; x < width; x++) {
+            for (unsigned int y = height - 1; y < height && position.get(x, y) != '0'; y--) {
+                bitBoard.play(x, position.get(x, y) == '1' ? 0 : 1);
+            }
+        }
+        bitBoards.push_back(bitBoard);
+    }
+
+    auto runKernel = [&](const std::string &name, AlignmentCounter counter) {
+        printResult(runBenchmark(name + " " + size, [&] {
+            for (const BitBoard &bitBoard: bitBoards) {
+                doNotOptimize(counter(bitBoard.discs(0), bitBoard.occupied(), bitBoard.getBoardMask(), height));
+            }
+            return bitBoards.size();
+        }));
+    };
+    runKernel("count alignments portable", &countAlignmentsPortable);
+#ifdef POWER4_X86_KERNELS
+    if (__builtin_cpu_supports("popcnt")) runKernel("count alignments popcnt", &countAlignmentsPopcnt);
+    if (__builtin_cpu_supports("avx2")) runKernel("count alignments avx2", &countAlignmentsAvx2);
+#endif
+
+    printResult(runBenchmark("computeScore " + size, [&] {
+        for (const Power4Game &position: positions) {
+            doNotOptimize(position.computeScore('1'));
+        }
+        return positions.size();
+    }));
+}
+
+/**
+ * Compares the checked access of the public API with the unchecked one (which only asserts in debug builds)
+ */
+template<typename Access>
+void runAccessBenchmark(const std::string &name, const std::vector<Power4Game> &positions) {
+    printResult(runBenchmark("read all cells " + name, [&] {
+        unsigned long cells = 0;
+        for (const Power4Game &position: positions) {
+            for (unsigned int y = 0; y < position.getHeight(); y++) {
+                for (unsigned int x = 0; x < position.getWidth(); x++) {
+                    doNotOptimize(position.get<Access>(x, y));
+                }
+            }
+            cells += position.getWidth() * position.getHeight();
+        }
+        return cells;
+    }));
+
+    printResult(runBenchmark("computeScore " + name, [&] {
+        for (const Power4Game &position: positions) {
+            doNotOptimize(position.computeScore<Access>('1'));
+        }
+        return positions.size();
+    }));
+}
+
+inline void runAccessBenchmarks(unsigned int width, unsigned int height) {
+    const std::vector<Power4Game> positions = randomPositions(width, height, 1000);
+    runAccessBenchmark<CheckedAccess>(std::format("{}x{} checked", width, height), positions);
+    runAccessBenchmark<UncheckedAccess>(std::format("{}x{} unchecked", width, height), positions);
+}
+
+
+#endif //POWER4_BOARDBENCHMARKS_HPP
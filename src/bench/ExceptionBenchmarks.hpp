@@ -0,0 +1,81 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_EXCEPTIONBENCHMARKS_HPP
+#define POWER4_EXCEPTIONBENCHMARKS_HPP
+
+
+#include <stdexcept>
+#include <string>
+#include "Benchmark.hpp"
+#include "../game/Power4Game.hpp"
+
+#ifndef POWER4_NO_TRACING
+
+/**
+ * What TracedException did before it only captured the addresses of the frames: resolving them to functions and lines
+ * when thrown, kept to measure the difference
+ */
+class EagerTracedException : public std::runtime_error {
+public:
+    std::vector<cpptrace::stacktrace_frame> frames;
+
+    explicit EagerTracedException(const std::string &message)
+            : runtime_error(message), frames(cpptrace::generate_trace()) {}
+};
+
+#endif
+
+/**
+ * Measures the cost of throwing and catching the exceptions of the game: an OutOfRangeException, which captures the
+ * addresses of a stack trace unless built with POWER4_NO_TRACING, against an EagerTracedException (the trace resolved
+ * when thrown, like before) and a plain std::out_of_range. Printing the trace is not measured, it is only done when the
+ * program fails.
+ */
+inline void runExceptionBenchmarks() {
+#ifdef POWER4_NO_TRACING
+    const std::string tracing = " (no tracing)";
+#else
+    const std::string tracing = " (raw trace)";
+#endif
+    const Power4Game game;
+    printResult(runBenchmark("throw and catch OutOfRangeException" + tracing, [&] {
+        for (unsigned int i = 0; i < 100; i++) {
+            try {
+                doNotOptimize(game.get(game.getWidth() + i, 0u));
+            } catch (const OutOfRangeException &e) {
+                doNotOptimize(e);
+            }
+        }
+        return 100;
+    }));
+
+#ifndef POWER4_NO_TRACING
+    printResult(runBenchmark("throw and catch EagerTracedException", [&] {
+        for (unsigned int i = 0; i < 100; i++) {
+            try {
+                throw EagerTracedException("column " + std::to_string(game.getWidth() + i) + " out of range");
+            } catch (const EagerTracedException &e) {
+                doNotOptimize(e);
+            }
+        }
+        return 100;
+    }));
+#endif
+
+    Power4Game mutableGame;
+    printResult(runBenchmark("throw and catch std::out_of_range", [&] {
+        for (unsigned int i = 0; i < 100; i++) {
+            try {
+                mutableGame.addInColumn(mutableGame.getWidth() + i, '1');
+            } catch (const std::out_of_range &e) {
+                doNotOptimize(e);
+            }
+        }
+        return 100;
+    }));
+}
+
+
+#endif //POWER4_EXCEPTIONBENCHMARKS_HPP
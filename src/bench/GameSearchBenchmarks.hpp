@@ -0,0 +1,216 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_GAMESEARCHBENCHMARKS_HPP
+#define POWER4_GAMESEARCHBENCHMARKS_HPP
+
+
+#include <format>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include "Benchmark.hpp"
+#include "BoardBenchmarks.hpp"
+#include "../ai/AlphaBetaSearch.hpp"
+#include "../ai/GameSearch.hpp"
+#include "../game/Power4Game.hpp"
+#include "../game/TicTacToe.hpp"
+
+/**
+ * A SearchableGame whose methods are all virtual, standing for the interface a generic engine would search through
+ * without templates (see VirtualGameOf)
+ */
+template<typename Player>
+class VirtualGame : public Game<Player> {
+public:
+    [[nodiscard]] virtual bool hasWinner() const = 0;
+
+    [[nodiscard]] virtual unsigned int getMoveSlots() const = 0;
+
+    [[nodiscard]] virtual Player opponentOf(const Player &player) const = 0;
+
+    virtual bool play(unsigned int move, const Player &player) = 0;
+
+    virtual bool undo() = 0;
+};
+
+/**
+ * A VirtualGame forwarding to a SearchableGame
+ */
+template<SearchableGame G>
+class VirtualGameOf final : public VirtualGame<typename G::Player> {
+private:
+    typedef typename G::Player Player;
+    G game;
+
+public:
+    explicit VirtualGameOf(const G &game) : game(game) {}
+
+    double getScore(const Player &player) const override {
+        return game.getScore(player);
+    }
+
+    std::vector<Player> getPlayers() const override {
+        return game.getPlayers();
+    }
+
+    [[nodiscard]] bool isDraw() const override {
+        return game.isDraw();
+    }
+
+    std::optional<Player> getOptionalWinner() const override {
+        return game.getOptionalWinner();
+    }
+
+    std::unique_ptr<Player> getWinner() const override {
+        return game.getWinner();
+    }
+
+    [[nodiscard]] bool hasWinner() const override {
+        return game.hasWinner();
+    }
+
+    [[nodiscard]] unsigned int getMoveSlots() const override {
+        return game.getMoveSlots();
+    }
+
+    [[nodiscard]] Player opponentOf(const Player &player) const override {
+        return game.opponentOf(player);
+    }
+
+    bool play(unsigned int move, const Player &player) override {
+        return game.play(move, player);
+    }
+
+    bool undo() override {
+        return game.undo();
+    }
+};
+
+/**
+ * A SearchableGame that only has the methods of Game to find the winner and the opponent, like an engine written
+ * against Game: getWinner allocates the winner and getPlayers a vector on each call
+ */
+template<typename P>
+class GameInterfaceOf {
+private:
+    VirtualGame<P> &game;
+
+public:
+    typedef P Player;
+
+    explicit GameInterfaceOf(VirtualGame<P> &game) : game(game) {}
+
+    [[nodiscard]] double getScore(const Player &player) const {
+        return game.getScore(player);
+    }
+
+    [[nodiscard]] bool isDraw() const {
+        return game.isDraw();
+    }
+
+    [[nodiscard]] bool hasWinner() const {
+        return game.getWinner() != nullptr;
+    }
+
+    [[nodiscard]] unsigned int getMoveSlots() const {
+        return game.getMoveSlots();
+    }
+
+    [[nodiscard]] Player opponentOf(const Player &player) const {
+        const std::vector<Player> players = game.getPlayers();
+        return players[0] == player ? players[1] : players[0];
+    }
+
+    bool play(unsigned int move, const Player &player) {
+        return game.play(move, player);
+    }
+
+    bool undo() {
+        return game.undo();
+    }
+};
+
+/**
+ * Time per node of the same GameSearch on a game, with the calls resolved at compile time, then through VirtualGame,
+ * then through GameInterfaceOf
+ */
+template<SearchableGame G>
+void runGameSearchBenchmark(const std::string &name, const G &start, const typename G::Player &player,
+                            unsigned int depth) {
+    G game = start;
+    GameSearch<G> staticSearch(depth);
+    const GameSearchResult result = staticSearch.search(game, player);
+    std::cout << std::format("{:<40} depth {:>2} move {} score {:>11} {:>10} nodes", name, depth, result.move,
+                             result.score, result.nodes) << std::endl;
+    printResult(runBenchmark(std::format("{} static depth {}", name, depth), [&] {
+        return staticSearch.search(game, player).nodes;
+    }));
+
+    VirtualGameOf<G> virtualGame(start);
+    VirtualGame<typename G::Player> &erased = virtualGame;
+    GameSearch<VirtualGame<typename G::Player>> virtualSearch(depth);
+    printResult(runBenchmark(std::format("{} virtual depth {}", name, depth), [&] {
+        return virtualSearch.search(erased, player).nodes;
+    }));
+
+    GameInterfaceOf<typename G::Player> interface(erased);
+    GameSearch<GameInterfaceOf<typename G::Player>> interfaceSearch(depth);
+    printResult(runBenchmark(std::format("{} Game interface depth {}", name, depth), [&] {
+        return interfaceSearch.search(interface, player).nodes;
+    }));
+}
+
+/**
+ * Checks GameSearch before timing it: it must solve tic-tac-toe as a draw, find the win of a won tic-tac-toe
+ * position, and give the scores of AlphaBetaSearch at the same depth on random Power4 positions
+ * @throws std::runtime_error on the first difference
+ */
+inline void checkGameSearch() {
+    TicTacToe ticTacToe;
+    GameSearch<TicTacToe> ticTacToeSearch(TicTacToe::CELLS);
+    if (const int score = ticTacToeSearch.search(ticTacToe, 'X').score; score != 0) {
+        throw std::runtime_error(std::format("GameSearch scores the empty tic-tac-toe grid {}, not a draw", score));
+    }
+    ticTacToe.play(0, 'X');
+    ticTacToe.play(1, 'O'); // X can force a win with its third mark
+    const int winScore = ticTacToeSearch.search(ticTacToe, 'X').score;
+    if (winScore != GameSearch<TicTacToe>::WIN_SCORE - 5 || ticTacToe.getMoveCount() != 2) {
+        throw std::runtime_error(std::format("GameSearch scores a win in 5 plies of tic-tac-toe {}", winScore));
+    }
+
+    constexpr unsigned int depth = 4;
+    std::mt19937 random(13);
+    GameSearch<Power4Game> search(depth);
+    AlphaBetaSearch alphaBeta(depth, 1 << 20);
+    alphaBeta.setThreadCount(1);
+    unsigned int positions = 0;
+    while (positions < 200) {
+        Power4Game game;
+        playRandomMoves(game, random, random() % 12);
+        if (game.hasWinner() || game.isDraw()) continue;
+        const Power4Player player = game.getMoveCount() % 2 == 0 ? '1' : '2';
+        const std::uint64_t hash = game.getHash();
+        const int score = search.search(game, player).score;
+        if (game.getHash() != hash) throw std::runtime_error("GameSearch didn't give the game back as it was");
+        alphaBeta.getTranspositionTable().clear();
+        const int expected = alphaBeta.search(game, player).score;
+        if (score != expected) {
+            throw std::runtime_error(std::format("GameSearch scores a position {}, AlphaBetaSearch {}", score,
+                                                 expected));
+        }
+        positions++;
+    }
+    std::cout << std::format("GameSearch: tic-tac-toe solved as a draw, same scores as AlphaBetaSearch at depth {} on "
+                             "{} positions", depth, positions) << std::endl;
+}
+
+inline void runGameSearchBenchmarks() {
+    checkGameSearch();
+    runGameSearchBenchmark("generic search empty 7x6", Power4Game(), Power4Player{'1'}, 6);
+    runGameSearchBenchmark("generic search tic-tac-toe", TicTacToe(), TicTacToePlayer{'X'}, TicTacToe::CELLS);
+}
+
+
+#endif //POWER4_GAMESEARCHBENCHMARKS_HPP
@@ -0,0 +1,38 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_PERFTBENCHMARKS_HPP
+#define POWER4_PERFTBENCHMARKS_HPP
+
+
+#include <format>
+#include <thread>
+#include "Benchmark.hpp"
+#include "../perft/Perft.hpp"
+
+/**
+ * Time per move played by perft from the empty board, which only plays and undoes moves: without a table, with one
+ * (fewer moves, but each one also probes the table), then with 2, 4... threads
+ */
+inline void runPerftBenchmarks(unsigned int width, unsigned int height, unsigned int depth) {
+    const Power4Game start(static_cast<int>(width), static_cast<int>(height));
+    const std::string name = std::format("perft {} {}x{}", depth, width, height);
+    printResult(runBenchmark(name, [&] {
+        return runPerft(start, depth, {1, 0, 0}).nodes;
+    }));
+    printResult(runBenchmark(name + " table", [&] {
+        return runPerft(start, depth, {1, 4 << 20, 0}).nodes;
+    }));
+
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency() == 0 ? 1
+                                                                                : std::thread::hardware_concurrency();
+    for (unsigned int threads = 2; threads <= hardwareThreads; threads *= 2) {
+        printResult(runBenchmark(std::format("{} {} threads", name, threads), [&] {
+            return runPerft(start, depth, {threads, 0, 3}).nodes;
+        }));
+    }
+}
+
+
+#endif //POWER4_PERFTBENCHMARKS_HPP
@@ -0,0 +1,106 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_SEARCHBENCHMARKS_HPP
+#define POWER4_SEARCHBENCHMARKS_HPP
+
+
+#include <iostream>
+#include <format>
+#include "BoardBenchmarks.hpp"
+#include <thread>
+#include "../ai/AlphaBetaSearch.hpp"
+#include "../ai/MonteCarloSearch.hpp"
+
+inline void printSearchResult(const std::string &name, const SearchResult &result, const TranspositionStats &stats) {
+    std::cout << std::format("{:<40} depth {:>2} column {} score {:>11} {:>10} nodes {:>9.1f} ms {:>12.0f} nodes/s "
+                             "TT hit rate {:>5.1f}%",
+                             name, result.depth, result.column, result.score, result.nodes,
+                             static_cast<double>(result.elapsed.count()) / 1e6, result.nodesPerSecond(),
+                             100 * stats.hitRate())
+              << std::endl;
+}
+
+inline void printSearchResult(const std::string &name, AlphaBetaSearch &search, const Power4Game &game,
+                              Power4Player player) {
+    // each search starts from an empty table, so that the results don't depend on the previous ones
+    search.getTranspositionTable().clear();
+    SearchResult result = search.search(game, player);
+    printSearchResult(name, result, search.getTableStats());
+}
+
+inline void runThinkBenchmark(std::chrono::milliseconds time) {
+    AlphaBetaSearch search(AlphaBetaSearch::MAX_DEPTH);
+    SearchResult result = search.think(Power4Game(), '1', time);
+    printSearchResult(std::format("think {} ms empty 7x6", time.count()), result, search.getTableStats());
+}
+
+/**
+ * Time to reach a depth, and nodes/s, with 1, 2, 4... threads up to the number of hardware threads
+ */
+inline void runParallelSearchBenchmarks(unsigned int depth, bool pinThreads) {
+    std::mt19937 random(11);
+    Power4Game game;
+    playRandomMoves(game, random, 6);
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency() == 0 ? 1
+                                                                                : std::thread::hardware_concurrency();
+    for (unsigned int threads = 1;; threads *= 2) {
+        if (threads > hardwareThreads) threads = hardwareThreads;
+        AlphaBetaSearch search(depth);
+        search.setThreadCount(threads);
+        search.setPinThreads(pinThreads);
+        printSearchResult(std::format("lazy SMP {} threads{}", threads, pinThreads ? " pinned" : ""), search, game,
+                          '1');
+        if (threads >= hardwareThreads) break;
+    }
+}
+
+inline void runSearchBenchmarks(unsigned int depth) {
+    AlphaBetaSearch search(depth);
+    printSearchResult("search empty 7x6", search, Power4Game(), '1');
+
+    std::mt19937 random(7);
+    for (int i = 0; i < 3; i++) {
+        Power4Game game;
+        playRandomMoves(game, random, 8);
+        if (game.hasWinner()) continue;
+        printSearchResult(std::format("search random 8 moves #{}", i), search, game, '1');
+    }
+}
+
+inline void printPlayoutResult(const std::string &name, const SearchResult &result) {
+    std::cout << std::format("{:<40} depth {:>2} column {} score {:>4} {:>10} playouts {:>9.1f} ms {:>12.0f} "
+                             "playouts/s",
+                             name, result.depth, result.column, result.score, result.nodes,
+                             static_cast<double>(result.elapsed.count()) / 1e6, result.nodesPerSecond())
+              << std::endl;
+}
+
+/**
+ * Playouts/s of the Monte Carlo search, with biased and fully random playouts, then with 1, 2, 4... threads
+ */
+inline void runMonteCarloBenchmarks(std::uint64_t playouts) {
+    for (bool biased: {true, false}) {
+        MonteCarloSearch search(playouts);
+        search.setBiasedPlayouts(biased);
+        printPlayoutResult(std::format("mcts empty 7x6{}", biased ? "" : " random playouts"),
+                           search.search(Power4Game(), '1'));
+    }
+
+    std::mt19937 random(11);
+    Power4Game game;
+    playRandomMoves(game, random, 6);
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency() == 0 ? 1
+                                                                                : std::thread::hardware_concurrency();
+    for (unsigned int threads = 1;; threads *= 2) {
+        if (threads > hardwareThreads) threads = hardwareThreads;
+        MonteCarloSearch search(playouts);
+        search.setThreadCount(threads);
+        printPlayoutResult(std::format("mcts {} threads", threads), search.search(game, '1'));
+        if (threads >= hardwareThreads) break;
+    }
+}
+
+
+#endif //POWER4_SEARCHBENCHMARKS_HPP
@@ -0,0 +1,116 @@
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include "BoardBenchmarks.hpp"
+#include "SearchBenchmarks.hpp"
+#include "ExceptionBenchmarks.hpp"
+#include "AllocationBenchmarks.hpp"
+#include "PerftBenchmarks.hpp"
+#include "GameSearchBenchmarks.hpp"
+
+/**
+ * Usage: Power4Bench [group] [--json file] [--repetitions n] [--warmup-ms n] [--sample-ms n]
+ *
+ * Runs all the benchmarks, or only one group of them: board, sizes, scaling, eval, access, exceptions, search, smp,
+ * mcts, alloc, perft or generic. Each benchmark is warmed up, then measured several times, see BenchmarkSettings. With
+ * --json, the results are also written to a file, see writeJson. The generic group first checks its search, see
+ * checkGameSearch, and fails if it is wrong.
+ */
+int main(int argc, char *argv[]) {
+    try {
+        std::string group;
+        std::optional<std::string> json;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) {
+                group = arg;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value after " << arg << std::endl;
+                return 2;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--json") json = value;
+            else if (arg == "--repetitions") benchmarkSettings.repetitions = std::stoul(value);
+            else if (arg == "--warmup-ms") benchmarkSettings.warmup = std::chrono::milliseconds(std::stoul(value));
+            else if (arg == "--sample-ms") {
+                benchmarkSettings.sampleDuration = std::chrono::milliseconds(std::stoul(value));
+            } else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return 2;
+            }
+        }
+        if (benchmarkSettings.repetitions == 0) throw std::invalid_argument("at least one repetition is needed");
+
+        if (group.empty() || group == "board") {
+            for (const auto &[width, height]: {std::pair{7u, 6u}, std::pair{8u, 7u}, std::pair{9u, 7u}}) {
+                runBoardBenchmarks(width, height);
+            }
+        }
+        if (group.empty() || group == "sizes") {
+            for (const auto &[width, height]: {std::pair{7u, 6u}, std::pair{8u, 7u}, std::pair{9u, 7u},
+                                               std::pair{10u, 7u}}) {
+                runSizeBenchmarks(width, height);
+            }
+        }
+        if (group.empty() || group == "scaling") {
+            for (const auto &[width, height]: {std::pair{7u, 6u}, std::pair{8u, 7u}, std::pair{9u, 7u},
+                                               std::pair{12u, 10u}, std::pair{16u, 14u}, std::pair{19u, 19u},
+                                               std::pair{24u, 24u}}) {
+                runScalingBenchmarks(width, height);
+            }
+        }
+        if (group.empty() || group == "eval") {
+            for (const auto &[width, height]: {std::pair{7u, 6u}, std::pair{8u, 7u}}) {
+                runEvalBenchmarks(width, height);
+            }
+        }
+        if (group.empty() || group == "access") {
+            for (const auto &[width, height]: {std::pair{7u, 6u}, std::pair{9u, 7u}}) {
+                runAccessBenchmarks(width, height);
+            }
+        }
+        if (group.empty() || group == "exceptions") {
+            runExceptionBenchmarks();
+        }
+        if (group.empty() || group == "search") {
+            for (unsigned int depth: {8u, 10u}) {
+                runSearchBenchmarks(depth);
+            }
+            runThinkBenchmark(std::chrono::milliseconds(100));
+        }
+        if (group.empty() || group == "smp") {
+            runParallelSearchBenchmarks(12, false);
+            runParallelSearchBenchmarks(12, true);
+        }
+        if (group.empty() || group == "mcts") {
+            runMonteCarloBenchmarks(500000);
+        }
+        if (group.empty() || group == "alloc") {
+            runAllocationBenchmarks();
+        }
+        if (group.empty() || group == "perft") {
+            runPerftBenchmarks(7, 6, 7);
+            runPerftBenchmarks(9, 7, 5);
+        }
+        if (group.empty() || group == "generic") {
+            runGameSearchBenchmarks();
+        }
+
+        if (json) {
+            std::ofstream out(*json);
+            if (!out) throw std::runtime_error("cannot write " + *json);
+            writeJson(out);
+        }
+        return 0;
+    } catch (const TracedException &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        e.printTrace();
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,205 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_ALIGNMENTKERNELS_HPP
+#define POWER4_ALIGNMENTKERNELS_HPP
+
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define POWER4_X86_KERNELS
+#include <immintrin.h>
+// inlines the portable code in the versions built for other instruction sets, instead of calling it
+#define POWER4_KERNEL_INLINE __attribute__((always_inline))
+#else
+#define POWER4_KERNEL_INLINE
+#endif
+
+/**
+ * Number of 2 and 3 aligned discs counted by Power4Game::getScore, by player index (the first player is 0)
+ */
+struct Alignments {
+    std::array<int, 2> aligns2{}, aligns3{};
+
+    bool operator==(const Alignments &other) const = default;
+};
+
+/*
+ * Counts the alignments of a whole BitBoard with masks instead of looking at each cell.
+ *
+ * getScore looks at each line of 6 cells, from 2 cells before to 3 cells after a disc (see Power4Game::computeScore).
+ * Here, the cells k steps after all the discs along a line are read at once by shifting the masks by k times the shift
+ * of the line. A shift can leave the board, or land on the extra empty bit on top of a column, but it only goes to
+ * another column from there, so every mask is combined with the one of the previous step that is still on the board.
+ *
+ * The three versions below give the same counts: a portable one, the same built for CPUs with popcnt, and an AVX2 one
+ * that handles the 4 directions at once. countBitBoardAlignments is the best one for the CPU, chosen at startup.
+ */
+
+/**
+ * @return the signed shifts of the bits going one cell further along each line, in the order of
+ * Power4Game::iteratorTypes. Lines go down the board (to lower rows) or to the right.
+ */
+constexpr std::array<int, 4> alignmentShifts(unsigned int height) {
+    const int h = static_cast<int>(height);
+    return {h + 1, -1, h, h + 2};
+}
+
+/**
+ * @return the cells k steps further than the cells of bits along a line of the given shift
+ */
+constexpr std::uint64_t stepsAhead(std::uint64_t bits, int shift, int k) {
+    const int n = k * shift;
+    return n > 0 ? bits >> n : bits << -n;
+}
+
+/**
+ * Counts the alignments of one player along one line
+ * @param discs the discs of the player
+ * @param empty the empty cells of the board
+ */
+POWER4_KERNEL_INLINE constexpr void countLineAlignments(std::uint64_t discs, std::uint64_t empty, int shift,
+                                                        int &aligns2, int &aligns3) {
+    const std::uint64_t pairs = discs & stepsAhead(discs, shift, 1);
+    const std::uint64_t third = stepsAhead(discs, shift, 2);
+    const std::uint64_t emptyAhead2 = stepsAhead(empty, shift, 2);
+    const std::uint64_t emptyAhead3 = stepsAhead(empty, shift, 3);
+    const std::uint64_t emptyBefore1 = stepsAhead(empty, shift, -1);
+    const std::uint64_t emptyBefore2 = stepsAhead(empty, shift, -2);
+
+    const std::uint64_t threes = pairs & third & ~stepsAhead(discs, shift, 3); // lines of 4 are wins, not counted
+    aligns3 += std::popcount(threes & emptyAhead3) + std::popcount(threes & emptyBefore1);
+    const std::uint64_t twos = pairs & ~third;
+    aligns2 += std::popcount(twos & emptyAhead2 & emptyAhead3) + std::popcount(twos & emptyBefore1 & emptyBefore2);
+}
+
+/**
+ * @param player1 the discs of the first player
+ * @param mask the discs of both players
+ * @param boardMask all the cells of the board
+ */
+POWER4_KERNEL_INLINE constexpr Alignments countAlignmentsPortable(std::uint64_t player1, std::uint64_t mask,
+                                                                  std::uint64_t boardMask, unsigned int height) {
+    Alignments alignments;
+    const std::uint64_t empty = boardMask & ~mask;
+    const std::array<std::uint64_t, 2> discs = {player1, player1 ^ mask};
+    for (int shift: alignmentShifts(height)) {
+        for (unsigned int player = 0; player < 2; player++) {
+            countLineAlignments(discs[player], empty, shift, alignments.aligns2[player], alignments.aligns3[player]);
+        }
+    }
+    return alignments;
+}
+
+#ifdef POWER4_X86_KERNELS
+
+__attribute__((target("popcnt")))
+inline Alignments countAlignmentsPopcnt(std::uint64_t player1, std::uint64_t mask, std::uint64_t boardMask,
+                                        unsigned int height) {
+    return countAlignmentsPortable(player1, mask, boardMask, height);
+}
+
+/**
+ * @return the number of bits set in each byte
+ */
+__attribute__((target("avx2")))
+inline __m256i popcountBytes(__m256i bits) {
+    const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(bits, lowNibbles)),
+                           _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(_mm256_srli_epi16(bits, 4), lowNibbles)));
+}
+
+/**
+ * stepsAhead with a signed shift in each lane, already multiplied by k. A lane shifted by 64 or more becomes 0, so this
+ * is a right shift or'ed with a left shift, one of them being by 64.
+ */
+__attribute__((target("avx2")))
+inline __m256i stepsAhead256(__m256i bits, __m256i shifts) {
+    const __m256i outOfRange = _mm256_set1_epi64x(64);
+    const __m256i isRight = _mm256_cmpgt_epi64(shifts, _mm256_setzero_si256());
+    const __m256i right = _mm256_blendv_epi8(outOfRange, shifts, isRight);
+    const __m256i left = _mm256_blendv_epi8(_mm256_sub_epi64(_mm256_setzero_si256(), shifts), outOfRange, isRight);
+    return _mm256_or_si256(_mm256_srlv_epi64(bits, right), _mm256_sllv_epi64(bits, left));
+}
+
+/**
+ * Same as countAlignmentsPortable, with one direction in each 64-bit lane
+ */
+__attribute__((target("avx2")))
+inline Alignments countAlignmentsAvx2(std::uint64_t player1, std::uint64_t mask, std::uint64_t boardMask,
+                                      unsigned int height) {
+    const std::array<int, 4> shifts = alignmentShifts(height);
+    const __m256i ahead1 = _mm256_setr_epi64x(shifts[0], shifts[1], shifts[2], shifts[3]);
+    const __m256i ahead2 = _mm256_add_epi64(ahead1, ahead1);
+    const __m256i ahead3 = _mm256_add_epi64(ahead2, ahead1);
+    const __m256i before1 = _mm256_sub_epi64(_mm256_setzero_si256(), ahead1);
+    const __m256i before2 = _mm256_sub_epi64(_mm256_setzero_si256(), ahead2);
+
+    const __m256i empty = _mm256_set1_epi64x(static_cast<long long>(boardMask & ~mask));
+    const __m256i emptyAhead3 = stepsAhead256(empty, ahead3);
+    const __m256i emptyBefore1 = stepsAhead256(empty, before1);
+    const __m256i emptyAhead23 = _mm256_and_si256(stepsAhead256(empty, ahead2), emptyAhead3);
+    const __m256i emptyBefore12 = _mm256_and_si256(emptyBefore1, stepsAhead256(empty, before2));
+
+    // the counts of each lane are below 2^16, they are packed in the 4 words of the lanes to be summed at once:
+    // aligns3 and aligns2 of the first player, then of the second one
+    __m256i packedCounts = _mm256_setzero_si256();
+    const std::array<std::uint64_t, 2> discs = {player1, player1 ^ mask};
+    for (unsigned int player = 0; player < 2; player++) {
+        const __m256i playerDiscs = _mm256_set1_epi64x(static_cast<long long>(discs[player]));
+        const __m256i pairs = _mm256_and_si256(playerDiscs, stepsAhead256(playerDiscs, ahead1));
+        const __m256i third = stepsAhead256(playerDiscs, ahead2);
+        const __m256i fourth = stepsAhead256(playerDiscs, ahead3);
+        const __m256i threes = _mm256_andnot_si256(fourth, _mm256_and_si256(pairs, third));
+        const __m256i twos = _mm256_andnot_si256(third, pairs);
+        const __m256i aligns3 = _mm256_sad_epu8(_mm256_add_epi8(
+                popcountBytes(_mm256_and_si256(threes, emptyAhead3)),
+                popcountBytes(_mm256_and_si256(threes, emptyBefore1))), _mm256_setzero_si256());
+        const __m256i aligns2 = _mm256_sad_epu8(_mm256_add_epi8(
+                popcountBytes(_mm256_and_si256(twos, emptyAhead23)),
+                popcountBytes(_mm256_and_si256(twos, emptyBefore12))), _mm256_setzero_si256());
+        packedCounts = _mm256_add_epi64(packedCounts, _mm256_slli_epi64(aligns3, static_cast<int>(32 * player)));
+        packedCounts = _mm256_add_epi64(packedCounts, _mm256_slli_epi64(aligns2, static_cast<int>(32 * player + 16)));
+    }
+    const __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(packedCounts),
+                                         _mm256_extracti128_si256(packedCounts, 1));
+    const auto sums = static_cast<std::uint64_t>(_mm_cvtsi128_si64(halves) + _mm_extract_epi64(halves, 1));
+
+    Alignments alignments;
+    for (unsigned int player = 0; player < 2; player++) {
+        alignments.aligns3[player] = static_cast<int>(sums >> (32 * player) & 0xffff);
+        alignments.aligns2[player] = static_cast<int>(sums >> (32 * player + 16) & 0xffff);
+    }
+    return alignments;
+}
+
+#endif
+
+typedef Alignments (*AlignmentCounter)(std::uint64_t player1, std::uint64_t mask, std::uint64_t boardMask,
+                                       unsigned int height);
+
+/**
+ * @return the fastest version of countBitBoardAlignments supported by this CPU
+ */
+inline AlignmentCounter bestAlignmentCounter() {
+#ifdef POWER4_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return &countAlignmentsAvx2;
+    if (__builtin_cpu_supports("popcnt")) return &countAlignmentsPopcnt;
+#endif
+    return &countAlignmentsPortable;
+}
+
+/**
+ * Counts the alignments of a BitBoard, see countAlignmentsPortable
+ */
+inline const AlignmentCounter countBitBoardAlignments = bestAlignmentCounter();
+
+
+#endif //POWER4_ALIGNMENTKERNELS_HPP
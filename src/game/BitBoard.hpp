@@ -0,0 +1,216 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_BITBOARD_HPP
+#define POWER4_BITBOARD_HPP
+
+
+#include <cstdint>
+#include <bit>
+#include <array>
+
+/**
+ * A Power4 position packed in two 64-bit masks: the discs of the first player and all the discs.
+ *
+ * Cells are stored column by column, starting from the bottom: the cell at column x and row r (0 being the bottom row)
+ * is bit x * (height + 1) + r. Each column has one more bit on top that always stays empty, so that shifting a line
+ * past the edge of a column never wraps into the next one. This means the board can only be used if
+ * width * (height + 1) <= 64, see BitBoard::fits.
+ */
+class BitBoard {
+private:
+    unsigned int width, height;
+    std::uint64_t bottomMask; // one bit at the bottom of each column
+    std::uint64_t boardMask; // all the playable cells
+    std::uint64_t player1 = 0; // discs of the first player
+    std::uint64_t mask = 0; // discs of both players
+
+    static std::uint64_t computeBottomMask(unsigned int width, unsigned int height) {
+        std::uint64_t bottom = 0;
+        for (unsigned int x = 0; x < width; x++) {
+            bottom |= std::uint64_t{1} << (x * (height + 1));
+        }
+        return bottom;
+    }
+
+    [[nodiscard]] std::uint64_t columnMask(unsigned int column) const {
+        return ((std::uint64_t{1} << height) - 1) << (column * (height + 1));
+    }
+
+    [[nodiscard]] std::uint64_t topMask(unsigned int column) const {
+        return std::uint64_t{1} << (column * (height + 1) + height - 1);
+    }
+
+public:
+    /**
+     * The shifts to apply to a mask to move along a line, in the same order as Power4Game::iteratorTypes
+     * (horizontal, vertical, diagonal down, diagonal up).
+     */
+    [[nodiscard]] static constexpr std::array<unsigned int, 4> lineShifts(unsigned int height) {
+        return {height + 1, 1, height, height + 2};
+    }
+
+    [[nodiscard]] std::array<unsigned int, 4> lineShifts() const {
+        return lineShifts(height);
+    }
+
+    /**
+     * @return true if a board of this size fits in 64 bits
+     */
+    static constexpr bool fits(unsigned int width, unsigned int height) {
+        return width * (height + 1) <= 64;
+    }
+
+    /**
+     * The masks are left empty if the board doesn't fit, so that it can be built whatever the size but not used
+     */
+    BitBoard(unsigned int width, unsigned int height)
+            : width(width), height(height), bottomMask(fits(width, height) ? computeBottomMask(width, height) : 0),
+              boardMask(fits(width, height) ? bottomMask * ((std::uint64_t{1} << height) - 1) : 0) {}
+
+    [[nodiscard]] unsigned int getWidth() const {
+        return width;
+    }
+
+    [[nodiscard]] unsigned int getHeight() const {
+        return height;
+    }
+
+    [[nodiscard]] std::uint64_t bit(unsigned int x, unsigned int row) const {
+        return std::uint64_t{1} << (x * (height + 1) + row);
+    }
+
+    /**
+     * @return the discs of a player, 0 being the first player and 1 the second one
+     */
+    [[nodiscard]] std::uint64_t discs(unsigned int playerIndex) const {
+        return playerIndex == 0 ? player1 : player1 ^ mask;
+    }
+
+    [[nodiscard]] std::uint64_t occupied() const {
+        return mask;
+    }
+
+    [[nodiscard]] std::uint64_t getBoardMask() const {
+        return boardMask;
+    }
+
+    /**
+     * @return 0 if the cell is empty, 1 for the first player, 2 for the second one
+     */
+    [[nodiscard]] unsigned int get(unsigned int x, unsigned int row) const {
+        return getBit(x * (height + 1) + row);
+    }
+
+    /**
+     * Like get, given the index of the bit of the cell
+     */
+    [[nodiscard]] unsigned int getBit(unsigned int index) const {
+        if (!(mask >> index & 1)) return 0;
+        return player1 >> index & 1 ? 1 : 2;
+    }
+
+    [[nodiscard]] bool canPlay(unsigned int column) const {
+        return !(mask & topMask(column));
+    }
+
+    /**
+     * Drops a disc in a column, which must not be full (see canPlay).
+     * @return the bit of the new disc
+     */
+    std::uint64_t play(unsigned int column, unsigned int playerIndex) {
+        std::uint64_t move = (mask + (bottomMask & columnMask(column))) & columnMask(column);
+        mask |= move;
+        if (playerIndex == 0) player1 |= move;
+        return move;
+    }
+
+    /**
+     * Removes the top disc of a column, which must not be empty
+     */
+    void undo(unsigned int column) {
+        std::uint64_t top = std::bit_floor(mask & columnMask(column));
+        mask ^= top;
+        player1 &= ~top;
+    }
+
+    /**
+     * @return the bits of the cells where a disc can be dropped, one per column that isn't full
+     */
+    [[nodiscard]] std::uint64_t playableCells() const {
+        return (mask + bottomMask) & boardMask;
+    }
+
+    [[nodiscard]] bool isFull() const {
+        return mask == boardMask;
+    }
+
+    /**
+     * @return the bits where a line of 4 discs starts, going towards higher bits by <code>shift</code>
+     */
+    [[nodiscard]] static constexpr std::uint64_t fourAnchors(std::uint64_t discs, unsigned int shift) {
+        std::uint64_t pairs = discs & (discs >> shift);
+        return pairs & (pairs >> (2 * shift));
+    }
+
+    /**
+     * @return true if these discs of a board of the given height contain 4 aligned discs in any direction
+     */
+    [[nodiscard]] static constexpr bool hasFour(std::uint64_t discs, unsigned int height) {
+        for (unsigned int shift: lineShifts(height)) {
+            if (fourAnchors(discs, shift)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @return the cells that would complete a line of 4 with these discs, whether they are empty or not, and even outside
+     * of the board: mask the result with the empty cells
+     */
+    [[nodiscard]] static constexpr std::uint64_t threats(std::uint64_t discs, unsigned int height) {
+        // vertical lines can only be completed on top
+        std::uint64_t cells = (discs << 1) & (discs << 2) & (discs << 3);
+        for (unsigned int shift: {height + 1, height, height + 2}) {
+            std::uint64_t below = (discs << shift) & (discs << 2 * shift); // the 2 previous cells are discs
+            cells |= below & (discs << 3 * shift);
+            cells |= below & (discs >> shift);
+            std::uint64_t above = (discs >> shift) & (discs >> 2 * shift); // the 2 next cells are discs
+            cells |= above & (discs << shift);
+            cells |= above & (discs >> 3 * shift);
+        }
+        return cells;
+    }
+
+    [[nodiscard]] bool hasFour(std::uint64_t discs) const {
+        return hasFour(discs, height);
+    }
+
+    /**
+     * @return a key that is unique for each position of this board size
+     */
+    [[nodiscard]] std::uint64_t key() const {
+        return player1 + mask + bottomMask;
+    }
+
+    /**
+     * @return the same position with the columns in reverse order
+     */
+    [[nodiscard]] BitBoard mirrored() const {
+        BitBoard mirror(width, height);
+        const std::uint64_t firstColumn = (std::uint64_t{1} << (height + 1)) - 1;
+        for (unsigned int x = 0; x < width; x++) {
+            const unsigned int from = x * (height + 1), to = (width - 1 - x) * (height + 1);
+            mirror.player1 |= (player1 >> from & firstColumn) << to;
+            mirror.mask |= (mask >> from & firstColumn) << to;
+        }
+        return mirror;
+    }
+
+    [[nodiscard]] unsigned int countDiscs() const {
+        return std::popcount(mask);
+    }
+};
+
+
+#endif //POWER4_BITBOARD_HPP
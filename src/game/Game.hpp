@@ -6,11 +6,18 @@
 #define POWER4_GAME_HPP
 
 
+#include <concepts>
 #include <vector>
 #include <memory>
+#include <optional>
 
-template<typename Player>
+template<typename P>
 class Game {
+public:
+    typedef P Player;
+
+    virtual ~Game() = default;
+
     /**
      * Returns the score of the player, higher is better.
      *
@@ -29,11 +36,38 @@ class Game {
     [[nodiscard]] virtual bool isDraw() const = 0;
 
     /**
-     * Returns the winner, nullptr if none.
+     * Returns the winner, std::nullopt if none.
      * If there is a winner, the game is over.
      */
+    virtual std::optional<Player> getOptionalWinner() const = 0;
+
+    /**
+     * Same as getOptionalWinner, nullptr if none.
+     */
     virtual std::unique_ptr<Player> getWinner() const = 0;
 };
 
+/**
+ * A two-player game that a search can play and undo moves in, without allocating: unlike through Game, the calls are
+ * resolved at compile time, so they can be inlined in a search templated on the game (see GameSearch). The methods
+ * of a class that also implements Game should then be final (or the class itself), or they stay virtual calls.
+ *
+ * - getMoveSlots(): the moves are numbered from 0 to getMoveSlots() - 1, whether they can be played or not
+ * - play(move, player): plays a move, false if it can't be played
+ * - undo(): undoes the last move played, false if there is none
+ * - opponentOf(player): the other player
+ * - hasWinner(), isDraw() and getScore(player) like in Game
+ */
+template<typename G>
+concept SearchableGame = requires(G &game, const G &constGame, const typename G::Player &player, unsigned int move) {
+    { constGame.getScore(player) } -> std::convertible_to<double>;
+    { constGame.hasWinner() } -> std::same_as<bool>;
+    { constGame.isDraw() } -> std::same_as<bool>;
+    { constGame.getMoveSlots() } -> std::same_as<unsigned int>;
+    { constGame.opponentOf(player) } -> std::same_as<typename G::Player>;
+    { game.play(move, player) } -> std::same_as<bool>;
+    { game.undo() } -> std::same_as<bool>;
+};
+
 
 #endif //POWER4_GAME_HPP
@@ -13,43 +13,276 @@
 #include <array>
 #include <limits>
 #include <format>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <algorithm>
+#include <functional>
 #include "Game.hpp"
+#include "BitBoard.hpp"
+#include "WideBitBoard.hpp"
+#include "AlignmentKernels.hpp"
 #include "../util/Coord.hpp"
 #include "../util/MathUtils.hpp"
 #include "color.hpp"
 #include "../util/OutOfRangeException.hpp"
+#include "../util/AccessPolicy.hpp"
 
 
 typedef unsigned char Power4Player;
 
-class Power4Game : public Game<Power4Player> {
+class Power4Game final : public Game<Power4Player> {
 private:
+    struct PlayedMove {
+        unsigned int column;
+        Alignments alignments; // before the move
+        bool alignmentsKnown = true; // false if alignments wasn't counted, see addInColumns
+    };
+
     unsigned int width, height;
-    std::vector<Power4Player> board;
-    mutable std::stack<unsigned int> computedWinnerCoords;
-    mutable bool isWinnerCoordsComputed = false;
+    bool hasBitBoard;
+    BitBoard bitBoard; // used if the board fits in 64 bits
+    AnyWideBitBoard wideBitBoard; // used otherwise if the board fits in one, see hasWideBitBoard
+    std::vector<Power4Player> board; // used for the largest boards, empty otherwise
+    std::uint64_t hash = 0;
+    std::vector<unsigned int> heights; // number of discs in each column
+    std::vector<PlayedMove> moves; // in order
+    std::array<unsigned int, 4> winningCells{}; // the first winning line, see getWinningCells
+    unsigned int winningMove = 0; // number of moves when winningCells was found, 0 if there is no winner
+    std::optional<Coord> lastPlaced;
+    void (Power4Game::*placeDiscImpl)(unsigned int, Power4Player); // see placeDiscFor
+    Alignments alignments; // counted by getScore, updated on each move
 
+    /**
+     * Steps between consecutive cells of a line, in the order of iteratorTypes
+     */
+    static constexpr std::array<std::array<int, 2>, 4> directions = {{{1, 0}, {0, 1}, {1, 1}, {1, -1}}};
+
+    template<typename Access = CheckedAccess>
     unsigned int getIndex(unsigned int x, unsigned int y) const {
-        if (x >= width)
-            throw OutOfRangeException(
-                    "x out of range, should be between 0 and " + std::to_string(width) + ", was " + std::to_string(x));
-        if (y >= height)
-            throw OutOfRangeException(
-                    "y out of range, should be between 0 and " + std::to_string(height) + ", was " + std::to_string(y));
+        Access::check(x, y, width, height);
         return y * width + x;
     }
 
-    void setWinnerCoords(const std::stack<unsigned int> &coords) const {
-        isWinnerCoordsComputed = true;
-        computedWinnerCoords = coords;
+    /*
+     * The methods used on each move take the size of the board as template parameters W and H, so that they can be
+     * instantiated for the usual sizes with constant bounds, shifts and strides (see placeDiscFor). W = H = 0 means
+     * the size is only known at runtime.
+     */
+
+    template<unsigned int W>
+    [[nodiscard]] unsigned int widthOf() const {
+        if constexpr (W == 0) return width;
+        else return W;
     }
 
-public:
+    template<unsigned int H>
+    [[nodiscard]] unsigned int heightOf() const {
+        if constexpr (H == 0) return height;
+        else return H;
+    }
+
+    template<unsigned int W, unsigned int H>
+    [[nodiscard]] bool usesBitBoard() const {
+        if constexpr (W == 0) return hasBitBoard;
+        else return BitBoard::fits(W, H);
+    }
+
+    [[nodiscard]] bool hasWideBitBoard() const {
+        return wideBitBoard.index() != 0;
+    }
+
+    /**
+     * Unchecked access to a cell, x and y must be in range
+     */
+    template<unsigned int W = 0, unsigned int H = 0>
+    [[nodiscard]] Power4Player cell(unsigned int x, unsigned int y) const {
+        UncheckedAccess::check(x, y, widthOf<W>(), heightOf<H>());
+        if (usesBitBoard<W, H>()) {
+            return '0' + bitBoard.getBit(x * (heightOf<H>() + 1) + heightOf<H>() - 1 - y);
+        }
+        if (!board.empty()) return board[y * widthOf<W>() + x];
+        return wideCell(x, y);
+    }
+
+    /**
+     * cell for the boards stored in a WideBitBoard, kept out of cell so that cell stays small enough to be inlined
+     */
+    [[nodiscard]] Power4Player wideCell(unsigned int x, unsigned int y) const {
+        return '0' + visitWideBitBoard(wideBitBoard, [&](const auto &wide) { return wide.get(x, height - 1 - y); });
+    }
+
+    /**
+     * Like BoardIterator::getOrEmpty, 0 outside the board
+     * @param cellAt reads a cell in range, like cell
+     */
+    template<unsigned int W = 0, unsigned int H = 0, typename CellAt>
+    [[nodiscard]] Power4Player cellOrEmpty(int x, int y, const CellAt &cellAt) const {
+        if (x < 0 || x >= static_cast<int>(widthOf<W>()) || y < 0 || y >= static_cast<int>(heightOf<H>())) return 0;
+        return cellAt(x, y);
+    }
 
-    Power4Game(int width, int height) : width(width), height(height), board(width * height, '0') {
+    template<unsigned int W = 0, unsigned int H = 0>
+    [[nodiscard]] Power4Player cellOrEmpty(int x, int y) const {
+        return cellOrEmpty<W, H>(x, y, [this](unsigned int cellX, unsigned int cellY) {
+            return cell<W, H>(cellX, cellY);
+        });
+    }
+
+    /**
+     * Adds sign times what getScore counts for the line starting at (x, y) in the given direction to alignments.
+     * Lines of 4 aren't counted, they are wins.
+     */
+    template<unsigned int W = 0, unsigned int H = 0, typename CellAt>
+    void countAlignments(int x, int y, const std::array<int, 2> &direction, int sign, const CellAt &cellAt) {
+        const auto &[dx, dy] = direction;
+        const Power4Player current = cellOrEmpty<W, H>(x, y, cellAt);
+        if (current != '1' && current != '2') return;
+        if (cellOrEmpty<W, H>(x + dx, y + dy, cellAt) != current) return;
+        const unsigned int playerIndex = current == '1' ? 0 : 1;
+        const bool hasSpaceBefore = cellOrEmpty<W, H>(x - dx, y - dy, cellAt) == '0';
+        const Power4Player third = cellOrEmpty<W, H>(x + 2 * dx, y + 2 * dy, cellAt);
+        const Power4Player fourth = cellOrEmpty<W, H>(x + 3 * dx, y + 3 * dy, cellAt);
+        if (third == current) {
+            if (fourth == current) return;
+            if (fourth == '0') alignments.aligns3[playerIndex] += sign;
+            if (hasSpaceBefore) alignments.aligns3[playerIndex] += sign;
+        } else {
+            if (third == '0' && fourth == '0') alignments.aligns2[playerIndex] += sign;
+            if (hasSpaceBefore && cellOrEmpty<W, H>(x - 2 * dx, y - 2 * dy, cellAt) == '0') {
+                alignments.aligns2[playerIndex] += sign;
+            }
+        }
+    }
+
+    /**
+     * Counts with the given sign all the lines getScore looks at that contain (x, y), i.e. the lines starting from 3
+     * cells before to 2 cells after it. Called with -1 before changing the cell, and with 1 after.
+     * @param cellAt reads a cell in range, like cell but for the storage of the board only
+     */
+    template<unsigned int W = 0, unsigned int H = 0, typename CellAt>
+    void countAlignmentsAround(unsigned int x, unsigned int y, int sign, const CellAt &cellAt) {
+        for (const auto &direction: directions) {
+            const auto &[dx, dy] = direction;
+            for (int k = -3; k <= 2; k++) {
+                countAlignments<W, H>(static_cast<int>(x) + k * dx, static_cast<int>(y) + k * dy, direction, sign,
+                                      cellAt);
+            }
+        }
+    }
+
+    /**
+     * Drops a disc in a column that isn't full, and updates the hash, the score and the winner
+     */
+    template<unsigned int W = 0, unsigned int H = 0>
+    void placeDisc(unsigned int column, Power4Player player) {
+        const unsigned int playerIndex = player == '1' ? 0 : 1;
+        const unsigned int y = heightOf<H>() - 1 - heights[column];
+        moves.push_back({column, alignments});
+        bool mayHaveFour = true; // false if the player can't have 4 aligned discs
+        if (usesBitBoard<W, H>()) {
+            bitBoard.play(column, playerIndex);
+            // recounting the whole board with masks is faster than updating the lines through the disc
+            alignments = countBitBoardAlignments(bitBoard.discs(0), bitBoard.occupied(), bitBoard.getBoardMask(),
+                                                 heightOf<H>());
+            mayHaveFour = BitBoard::hasFour(bitBoard.discs(playerIndex), heightOf<H>());
+        } else if (hasWideBitBoard()) {
+            // recounting a WideBitBoard costs more than counting the lines through the disc before and after it
+            visitWideBitBoard(wideBitBoard, [&](auto &wide) {
+                const unsigned int row = heights[column];
+                const CellLines before = wide.linesThrough(column, row), after = before.withDisc(playerIndex);
+                const Alignments removed = countCellLines(before), added = countCellLines(after);
+                for (unsigned int i = 0; i < 2; i++) {
+                    alignments.aligns2[i] += added.aligns2[i] - removed.aligns2[i];
+                    alignments.aligns3[i] += added.aligns3[i] - removed.aligns3[i];
+                }
+                wide.play(column, row, playerIndex);
+                mayHaveFour = after.hasFour(playerIndex);
+            });
+        } else {
+            const auto cellAt = [&](unsigned int cellX, unsigned int cellY) {
+                return board[cellY * widthOf<W>() + cellX];
+            };
+            countAlignmentsAround<W, H>(column, y, -1, cellAt);
+            board[y * widthOf<W>() + column] = player;
+            countAlignmentsAround<W, H>(column, y, 1, cellAt);
+        }
+        heights[column]++;
+
+        hash ^= zobristKey(y * widthOf<W>() + column, player);
+        lastPlaced.emplace(static_cast<int>(column), static_cast<int>(y));
+        if (winningMove == 0 && mayHaveFour) {
+            // a new winning line has to go through the new disc
+            if (findWinningLineThrough<W, H>(column, y, player)) winningMove = moves.size();
+        }
+    }
+
+    typedef void (Power4Game::*PlaceDisc)(unsigned int, Power4Player);
+
+    /**
+     * @return placeDisc instantiated for this size if it is a usual one, the generic placeDisc otherwise
+     */
+    static PlaceDisc placeDiscFor(unsigned int width, unsigned int height) {
+        if (width == 7 && height == 6) return &Power4Game::placeDisc<7, 6>;
+        if (width == 8 && height == 7) return &Power4Game::placeDisc<8, 7>;
+        if (width == 9 && height == 7) return &Power4Game::placeDisc<9, 7>;
+        if (width == 10 && height == 7) return &Power4Game::placeDisc<10, 7>;
+        return &Power4Game::placeDisc<>;
+    }
+
+    /**
+     * Looks for 4 aligned discs of player going through (x, y), and sets winningCells to the first window of 4 in the
+     * order of iteratorTypes, then from the left (or the top for vertical lines).
+     * @return true if there is one
+     */
+    template<unsigned int W = 0, unsigned int H = 0>
+    bool findWinningLineThrough(unsigned int x, unsigned int y, Power4Player player) {
+        for (const auto &[dx, dy]: directions) {
+            auto isPlayer = [&](int k) {
+                return cellOrEmpty<W, H>(static_cast<int>(x) + k * dx, static_cast<int>(y) + k * dy) == player;
+            };
+            int before = 0, after = 0;
+            while (before < 3 && isPlayer(-before - 1)) before++;
+            while (after < 3 && isPlayer(after + 1)) after++;
+            if (before + after + 1 < 4) continue;
+
+            for (int i = 0; i < 4; i++) {
+                int k = i - before;
+                winningCells[i] = (static_cast<int>(y) + k * dy) * widthOf<W>() + static_cast<int>(x) + k * dx;
+            }
+            // in the order they are printed
+            std::sort(winningCells.begin(), winningCells.end());
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @return width, once the size is checked: called by the first initializer, before the masks of the size are built
+     * @throws std::invalid_argument if width or height is less than 4
+     */
+    static unsigned int checkSize(int width, int height) {
         if (width < 4 || height < 4) {
             throw std::invalid_argument("width or height too small");
         }
+        return width;
+    }
+
+public:
+
+    /**
+     * @param specialized false to use the generic code on each move even for the usual sizes, to compare them
+     */
+    Power4Game(int width, int height, bool specialized = true)
+            : width(checkSize(width, height)), height(height), hasBitBoard(BitBoard::fits(width, height)), bitBoard(width, height),
+              wideBitBoard(makeWideBitBoard(width, height)),
+              placeDiscImpl(specialized ? placeDiscFor(width, height) : &Power4Game::placeDisc<>) {
+        if (!hasBitBoard && !hasWideBitBoard()) {
+            board.assign(width * height, '0');
+        }
+        heights.assign(width, 0);
+        moves.reserve(width * height);
     }
 
     Power4Game() : Power4Game(7, 6) {}
@@ -62,14 +295,20 @@ public:
         return height;
     }
 
+    /**
+     * @tparam Access CheckedAccess to throw an OutOfRangeException if x or y is out of range, UncheckedAccess if they
+     * are known to be in range
+     */
+    template<typename Access = CheckedAccess>
     [[nodiscard]] Power4Player get(unsigned int x, unsigned int y) const {
-        return board[getIndex(x, y)];
+        Access::check(x, y, width, height);
+        return cell(x, y);
     }
 
+    template<typename Access = CheckedAccess>
     [[nodiscard]] Power4Player get(int x, int y) const {
-        if (x < 0) throw OutOfRangeException("x out of range, should be positive, was " + std::to_string(x));
-        if (y < 0) throw OutOfRangeException("y out of range, should be positive, was " + std::to_string(y));
-        return board[getIndex(static_cast<unsigned int>(x), static_cast<unsigned int>(y))];
+        Access::checkPositive(x, y);
+        return get<Access>(static_cast<unsigned int>(x), static_cast<unsigned int>(y));
     }
 
     /**
@@ -82,16 +321,173 @@ public:
         if (column >= width) {
             throw std::out_of_range("column out of range");
         }
-        for (unsigned int y = height - 1;
-             y <= height; y--) { // loop will end when y underflows to the max value of unsigned int
-            unsigned int index = getIndex(column, y);
-            if (board[index] == '0') {
-                board[index] = player;
-                isWinnerCoordsComputed = false;
-                return true;
+        if (heights[column] == height) return false;
+        (this->*placeDiscImpl)(column, player);
+        return true;
+    }
+
+    /**
+     * Same as addInColumn, for SearchableGame
+     */
+    bool play(unsigned int column, Power4Player player) {
+        return addInColumn(column, player);
+    }
+
+    /**
+     * Adds several moves at once, the players alternating: '1' plays when the number of moves is even. Faster than
+     * addInColumn for boards that fit in a BitBoard, as the score is only counted after the last move.
+     * @return false if a column is full, the moves before it are still played
+     * @throws std::out_of_range if a column is out of range, before playing any move
+     */
+    bool addInColumns(std::span<const std::uint8_t> columns) {
+        for (std::uint8_t column: columns) {
+            if (column >= width) {
+                throw std::out_of_range("column out of range");
             }
         }
-        return false;
+        if (!hasBitBoard) {
+            for (std::uint8_t column: columns) {
+                if (!addInColumn(column, moves.size() % 2 == 0 ? '1' : '2')) return false;
+            }
+            return true;
+        }
+        bool played = true;
+        const std::size_t first = moves.size();
+        for (std::uint8_t column: columns) {
+            if (heights[column] == height) {
+                played = false;
+                break;
+            }
+            const unsigned int playerIndex = moves.size() % 2;
+            const Power4Player player = playerIndex == 0 ? '1' : '2';
+            const unsigned int y = height - 1 - heights[column];
+            // only the alignments before the first move are known
+            moves.push_back({column, alignments, moves.size() == first});
+            bitBoard.play(column, playerIndex);
+            heights[column]++;
+            hash ^= zobristKey(y * width + column, player);
+            if (winningMove == 0 && BitBoard::hasFour(bitBoard.discs(playerIndex), height)) {
+                if (findWinningLineThrough(column, y, player)) winningMove = moves.size();
+            }
+        }
+        if (moves.size() != first) {
+            alignments = countBitBoardAlignments(bitBoard.discs(0), bitBoard.occupied(), bitBoard.getBoardMask(),
+                                                 height);
+            const unsigned int last = moves.back().column;
+            lastPlaced.emplace(static_cast<int>(last), static_cast<int>(height - heights[last]));
+        }
+        return played;
+    }
+
+    /**
+     * Removes the last disc added, restoring the game as it was before it was added
+     * @return false if there is no disc to remove
+     */
+    bool undo() {
+        if (moves.empty()) return false;
+        if (winningMove == moves.size()) {
+            winningMove = 0;
+        }
+        const PlayedMove &move = moves.back();
+        const unsigned int column = move.column;
+        const bool alignmentsKnown = move.alignmentsKnown;
+        const unsigned int y = height - heights[column];
+        hash ^= zobristKey(y * width + column, cell(column, y));
+        alignments = move.alignments;
+        moves.pop_back();
+        if (hasBitBoard) {
+            bitBoard.undo(column);
+            if (!alignmentsKnown) {
+                alignments = countBitBoardAlignments(bitBoard.discs(0), bitBoard.occupied(), bitBoard.getBoardMask(),
+                                                     height);
+            }
+        } else if (hasWideBitBoard()) {
+            visitWideBitBoard(wideBitBoard, [&](auto &wide) { wide.undo(column, heights[column] - 1); });
+        } else {
+            board[y * width + column] = '0';
+        }
+        heights[column]--;
+        if (moves.empty()) {
+            lastPlaced.reset();
+        } else {
+            const unsigned int previousColumn = moves.back().column;
+            lastPlaced.emplace(static_cast<int>(previousColumn), static_cast<int>(height - heights[previousColumn]));
+        }
+        return true;
+    }
+
+    /**
+     * Removes the top disc of a column, which must be the last disc added (see undo)
+     * @return false if the column is empty
+     */
+    bool removeFromColumn(unsigned int column) {
+        if (column >= width) {
+            throw std::out_of_range("column out of range");
+        }
+        if (heights[column] == 0) return false;
+        if (moves.back().column != column) {
+            throw std::invalid_argument("only the last disc added can be removed, it is in column "
+                                        + std::to_string(moves.back().column));
+        }
+        return undo();
+    }
+
+    /**
+     * @return the number of discs in a column
+     */
+    [[nodiscard]] unsigned int getColumnHeight(unsigned int column) const {
+        if (column >= width) {
+            throw std::out_of_range("column out of range");
+        }
+        return heights[column];
+    }
+
+    /**
+     * @return the number of discs on the board
+     */
+    [[nodiscard]] unsigned int getMoveCount() const {
+        return moves.size();
+    }
+
+    /**
+     * @return the column of a move, the first move being 0
+     * @throws std::out_of_range if ply >= getMoveCount()
+     */
+    [[nodiscard]] unsigned int getPlayedColumn(unsigned int ply) const {
+        if (ply >= moves.size()) {
+            throw std::out_of_range("only " + std::to_string(moves.size()) + " moves were played");
+        }
+        return moves[ply].column;
+    }
+
+    /**
+     * @return the lines of 2 and 3 discs counted by getScore
+     */
+    [[nodiscard]] const Alignments &getAlignments() const {
+        return alignments;
+    }
+
+    /**
+     * @return the position as a BitBoard, nullptr if the board doesn't fit in 64 bits (it may use a WideBitBoard then,
+     * which is kept private as its type depends on the size)
+     */
+    [[nodiscard]] const BitBoard *getBitBoard() const {
+        return hasBitBoard ? &bitBoard : nullptr;
+    }
+
+    /**
+     * Zobrist key of a disc, the hash of a position being the xor of the keys of all its discs
+     */
+    [[nodiscard]] static std::uint64_t zobristKey(unsigned int index, Power4Player player) {
+        return splitMix64(2 * index + (player == '1' ? 0 : 1));
+    }
+
+    /**
+     * @return the Zobrist hash of the position, updated on each move. Two positions with the same discs have the same
+     * hash, whatever the order the discs were played in.
+     */
+    [[nodiscard]] std::uint64_t getHash() const {
+        return hash;
     }
 
     enum IteratorType {
@@ -103,17 +499,18 @@ public:
 
     static constexpr std::array<IteratorType, 4> iteratorTypes = {HORIZONTAL, VERTICAL, DIAGONAL_DOWN, DIAGONAL_UP};
 
-    class BoardIterator {
+    template<typename Access>
+    class BasicBoardIterator {
     private:
         const Power4Game *game;
         const IteratorType iteratorType;
         int x, y; // current coordinates
 
     public:
-        BoardIterator(const Power4Game *game, const IteratorType iteratorType, const int startX, const int startY)
+        BasicBoardIterator(const Power4Game *game, const IteratorType iteratorType, const int startX, const int startY)
                 : game(game), iteratorType(iteratorType), x(startX), y(startY) {}
 
-        BoardIterator(const Power4Game *game, const IteratorType iteratorType)
+        BasicBoardIterator(const Power4Game *game, const IteratorType iteratorType)
                 : game(game), iteratorType(iteratorType), x(0), y(0) {}
 
         [[nodiscard]] IteratorType getIteratorType() const {
@@ -127,17 +524,17 @@ public:
 
         Power4Player operator*() const {
             // Deference operator
-            return game->get(x, y);
+            return game->get<Access>(x, y);
         }
 
         [[nodiscard]] Power4Player getOrEmpty() const {
             if (isInBoard()) {
-                return game->get(x, y);
+                return game->get<Access>(x, y);
             }
             return 0;
         }
 
-        BoardIterator &operator++() {
+        BasicBoardIterator &operator++() {
             // Prefix increment operator
             switch (iteratorType) {
                 case HORIZONTAL:
@@ -158,7 +555,7 @@ public:
             return *this;
         }
 
-        BoardIterator &operator--() {
+        BasicBoardIterator &operator--() {
             // Prefix decrement operator
             switch (iteratorType) {
                 case HORIZONTAL:
@@ -179,15 +576,20 @@ public:
             return *this;
         }
 
-        bool operator!=(const BoardIterator &other) const {
+        bool operator!=(const BasicBoardIterator &other) const {
             return x != other.x || y != other.y || iteratorType != other.iteratorType;
         }
 
-        bool operator==(const BoardIterator &other) const {
+        bool operator==(const BasicBoardIterator &other) const {
             return !(*this != other);
         }
     };
 
+    /**
+     * Iterator throwing an OutOfRangeException when dereferenced outside the board
+     */
+    typedef BasicBoardIterator<CheckedAccess> BoardIterator;
+
 private:
     static constexpr double WIN_SCORE = std::numeric_limits<double>::infinity();
     static constexpr double SCORE_3_ALIGNED = 10;
@@ -199,15 +601,55 @@ private:
 
 public:
     /**
-     * Returns the score of the player, higher is better
+     * @return the score of getScore for a position without a winner, from its alignments
+     */
+    [[nodiscard]] static double scoreOf(const Alignments &alignments, Power4Player player) {
+        double p1Score = calculateScore(alignments.aligns2[0], alignments.aligns3[0])
+                         - calculateScore(alignments.aligns2[1], alignments.aligns3[1]);
+        return player == '1' ? p1Score : -p1Score;
+    }
+
+    /**
+     * @return the score of getScore for a position won by winner
+     */
+    [[nodiscard]] static double winScore(Power4Player winner) {
+        return winner == '1' ? WIN_SCORE : -WIN_SCORE;
+    }
+
+    /**
+     * Returns the score of the player, higher is better. The aligned discs are counted on each move, so this is O(1).
      *
      * Scores:
      * - 2 aligned: 5n (n = number of 2 aligned)
      * - 3 aligned: 10^n (n = number of 3 aligned)
      * - 4 aligned: infinite
      * Subtract the same score for the opponent
+     *
+     * Define POWER4_CHECK_EVAL to check each score against computeScore.
      */
     [[nodiscard]] double getScore(const Power4Player &player) const override {
+        double score;
+        if (hasWinner()) {
+            score = winScore(cell(winningCells[0] % width, winningCells[0] / width));
+        } else {
+            score = scoreOf(alignments, player);
+        }
+#ifdef POWER4_CHECK_EVAL
+        // once someone won, computeScore is infinite for the first line of 4 it finds, whoever it belongs to
+        if (!hasWinner() && score != computeScore(player)) {
+            throw std::logic_error(std::format("incremental score {} differs from computed score {}", score,
+                                               computeScore(player)));
+        }
+#endif
+        return score;
+    }
+
+    /**
+     * Computes the same score as getScore by scanning the whole board
+     * @tparam Access the access to the cells, only checked for benchmarks as the iterators never leave the board
+     */
+    template<typename Access = UncheckedAccess>
+    [[nodiscard]] double computeScore(const Power4Player &player) const {
         unsigned int p1Aligns2 = 0;
         unsigned int p1Aligns3 = 0;
         unsigned int p2Aligns2 = 0;
@@ -233,7 +675,7 @@ public:
                             startY += 2;
                             break;
                     }
-                    BoardIterator boardIterator{this, iteratorType, startX, startY};
+                    BasicBoardIterator<Access> boardIterator{this, iteratorType, startX, startY};
                     const bool hasSpace2Before = boardIterator.getOrEmpty() == '0';
                     const bool hasSpaceBefore = (++boardIterator).getOrEmpty() == '0';
 
@@ -285,21 +727,60 @@ public:
         return {'1', '2'};
     }
 
+    [[nodiscard]] static Power4Player opponentOf(Power4Player player) {
+        return player == '1' ? '2' : '1';
+    }
+
+    /**
+     * @return the width, as the moves of SearchableGame are the columns
+     */
+    [[nodiscard]] unsigned int getMoveSlots() const {
+        return width;
+    }
+
     /**
      * Count elements with a given predicate, returning true or false for each element
      */
     template<typename P>
     int count(P &&predicate) const {
         int count = 0;
-        for (const auto &item: board) {
-            if (predicate(item)) {
-                count++;
+        for (unsigned int y = 0; y < height; y++) {
+            for (unsigned int x = 0; x < width; x++) {
+                if (predicate(cell(x, y))) {
+                    count++;
+                }
             }
         }
         return count;
     }
 
     [[nodiscard]] int count(Power4Player value) const {
+        if (hasBitBoard) {
+            switch (value) {
+                case '0':
+                    return static_cast<int>(width * height - bitBoard.countDiscs());
+                case '1':
+                    return std::popcount(bitBoard.discs(0));
+                case '2':
+                    return std::popcount(bitBoard.discs(1));
+                default:
+                    return 0;
+            }
+        }
+        if (hasWideBitBoard()) {
+            return visitWideBitBoard(wideBitBoard, [&](const auto &wide) {
+                switch (value) {
+                    case '0':
+                        return static_cast<int>(width * height - wide.countDiscs());
+                    case '1':
+                        return bitCount(wide.discs(0));
+                    case '2':
+                        return bitCount(wide.discs(1));
+                    default:
+                        return 0;
+                }
+            });
+        }
         int count = 0;
         for (const auto &item: board) {
             if (item == value) {
@@ -310,95 +791,59 @@ public:
     }
 
     [[nodiscard]] bool isDraw() const override {
-        for (unsigned int x = 0; x < width; x++) {
-            if (board[getIndex(x, 0)] == '0') {
-                return false;
-            }
-        }
-        return true;
+        return moves.size() == width * height;
+    }
+
+    /**
+     * Winner detection only looks at the lines going through the last disc, when it is placed, so this is O(1).
+     */
+    [[nodiscard]] bool hasWinner() const {
+        return winningMove != 0;
     }
 
+    [[nodiscard]] std::optional<Power4Player> getOptionalWinner() const override {
+        if (!hasWinner()) return std::nullopt;
+        return cell(winningCells[0] % width, winningCells[0] / width);
+    }
+
+    /**
+     * Like getOptionalWinner, but allocates. Kept for the code written before it.
+     */
     [[nodiscard]] std::unique_ptr<Power4Player> getWinner() const override {
-        std::stack<unsigned int> coords = getWinnerCoords();
-        if (coords.empty()) return {nullptr};
-        unsigned int coord0 = coords.top();
-        return std::make_unique<Power4Player>(board[coord0]);
+        std::optional<Power4Player> winner = getOptionalWinner();
+        if (!winner) return {nullptr};
+        return std::make_unique<Power4Player>(*winner);
+    }
+
+    /**
+     * @return the indexes (y * width + x) of the cells of the winning line, sorted by ascending index, so in the order
+     * they are printed. Empty if no winner. Only valid until the next move or undo.
+     */
+    [[nodiscard]] std::span<const unsigned int> getWinningCells() const {
+        if (!hasWinner()) return {};
+        return winningCells;
     }
 
     /**
-     * This uses a cache.
-     * @return a vector of all coords that are part of the winning line, sorted by descending x then descending y,
-     * meaning that std::queue::top() will return the coords with the lowest x then lowest y.
-     * Empty if no winner.
+     * Like getWinningCells, but copies them in a stack. Kept for the code written before it.
+     * @return the cells of the winning line, top() being the one with the lowest index. Empty if no winner.
      */
     [[nodiscard]] std::stack<unsigned int> getWinnerCoords() const {
-        if (isWinnerCoordsComputed) {
-            return computedWinnerCoords;
-        }
         std::stack<unsigned int> coords;
-        // Horizontal
-        for (unsigned int y = 0; y < height; y++) {
-            for (unsigned int x = 0; x < width - 3; x++) {
-                Power4Player value = board[getIndex(x, y)];
-                if (value != '0' && value == board[getIndex(x + 1, y)] && value == board[getIndex(x + 2, y)] &&
-                    value == board[getIndex(x + 3, y)]) {
-                    coords.emplace(getIndex(x + 3, y));
-                    coords.emplace(getIndex(x + 2, y));
-                    coords.emplace(getIndex(x + 1, y));
-                    coords.emplace(getIndex(x, y));
-                    setWinnerCoords(coords);
-                    return coords;
-                }
-            }
+        for (auto it = winningCells.rbegin(); hasWinner() && it != winningCells.rend(); ++it) {
+            coords.push(*it);
         }
-        // Vertical
-        for (unsigned int x = 0; x < width; x++) {
-            for (unsigned int y = 0; y < height - 3; y++) {
-                Power4Player value = board[getIndex(x, y)];
-                if (value != '0' && value == board[getIndex(x, y + 1)] && value == board[getIndex(x, y + 2)] &&
-                    value == board[getIndex(x, y + 3)]) {
-                    coords.emplace(getIndex(x, y + 3));
-                    coords.emplace(getIndex(x, y + 2));
-                    coords.emplace(getIndex(x, y + 1));
-                    coords.emplace(getIndex(x, y));
-                    setWinnerCoords(coords);
-                    return coords;
-                }
-            }
-        }
-        // Diagonal
-        for (unsigned int x = 0; x < width - 3; x++) {
-            for (unsigned int y = 0; y < height - 3; y++) {
-                Power4Player value = board[getIndex(x, y)];
-                if (value != '0' && value == board[getIndex(x + 1, y + 1)] && value == board[getIndex(x + 2, y + 2)] &&
-                    value == board[getIndex(x + 3, y + 3)]) {
-                    coords.emplace(getIndex(x + 3, y + 3));
-                    coords.emplace(getIndex(x + 2, y + 2));
-                    coords.emplace(getIndex(x + 1, y + 1));
-                    coords.emplace(getIndex(x, y));
-                    setWinnerCoords(coords);
-                    return coords;
-                }
-            }
-        }
-        for (unsigned int x = 0; x < width - 3; x++) {
-            for (unsigned int y = 3; y < height; y++) {
-                Power4Player value = board[getIndex(x, y)];
-                if (value != '0' && value == board[getIndex(x + 1, y - 1)] && value == board[getIndex(x + 2, y - 2)] &&
-                    value == board[getIndex(x + 3, y - 3)]) {
-                    coords.emplace(getIndex(x, y));
-                    coords.emplace(getIndex(x + 1, y - 1));
-                    coords.emplace(getIndex(x + 2, y - 2));
-                    coords.emplace(getIndex(x + 3, y - 3));
-                    setWinnerCoords(coords);
-                    return coords;
-                }
-            }
-        }
-        setWinnerCoords(coords);
         return coords;
     }
 
+    /**
+     * @return the last disc placed by addInColumn, if any
+     */
+    [[nodiscard]] std::optional<Coord> getLastPlaced() const {
+        return lastPlaced;
+    }
+
+public:
     /**
      * Prints the board to stdout
      */
@@ -408,13 +853,13 @@ public:
             std::cout << letter << " ";
         }
         std::cout << std::endl;
-        std::stack<unsigned int> winnerCoords = getWinnerCoords();
+        std::span<const unsigned int> highlighted = getWinningCells();
         for (unsigned int y = 0; y < height; y++) {
             for (unsigned int x = 0; x < width; x++) {
-                Power4Player value = board[getIndex(x, y)];
-                if (!winnerCoords.empty() && winnerCoords.top() == getIndex(x, y)) {
+                Power4Player value = cell(x, y);
+                if (!highlighted.empty() && highlighted.front() == getIndex<UncheckedAccess>(x, y)) {
                     std::cout << dye::yellow(value);
-                    winnerCoords.pop();
+                    highlighted = highlighted.subspan(1);
                 } else {
                     switch (value) {
                         case '0':
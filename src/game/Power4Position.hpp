@@ -0,0 +1,182 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_POWER4POSITION_HPP
+#define POWER4_POWER4POSITION_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "Power4Game.hpp"
+#include "BitBoard.hpp"
+#include "AlignmentKernels.hpp"
+#include "../util/AccessPolicy.hpp"
+
+/**
+ * An immutable snapshot of a Power4Game, for the boards that fit in a BitBoard.
+ *
+ * It is trivially copyable (about 100 bytes, no heap memory) and has no cache: all its methods only read it, so any
+ * number of threads can use the same position at once without locks. Moves give new positions instead of changing
+ * this one, see afterMove.
+ *
+ * The queries give the same results as the ones of Power4Game with the same name, with the same coordinates.
+ */
+class Power4Position {
+private:
+    BitBoard bitBoard;
+    std::uint64_t hash;
+    Alignments alignments; // see Power4Game::getAlignments
+    unsigned int moveCount;
+    bool won;
+    std::array<unsigned int, 4> winningCells; // see Power4Game::getWinningCells, meaningless if !won
+
+    [[nodiscard]] unsigned int bitIndex(unsigned int x, unsigned int y) const {
+        return x * (bitBoard.getHeight() + 1) + bitBoard.getHeight() - 1 - y;
+    }
+
+    /**
+     * @return the index (y * width + x) of a cell given by its bit in the BitBoard
+     */
+    [[nodiscard]] unsigned int cellIndex(unsigned int bit) const {
+        const unsigned int x = bit / (bitBoard.getHeight() + 1);
+        const unsigned int y = bitBoard.getHeight() - 1 - bit % (bitBoard.getHeight() + 1);
+        return y * bitBoard.getWidth() + x;
+    }
+
+    /**
+     * Finds the winning line through a new disc like Power4Game does: the first direction of
+     * Power4Game::iteratorTypes that has one, then the window of 4 the most on the left (or at the top for vertical
+     * lines, there is only one since the new disc is on top).
+     * @return true if there is one
+     */
+    bool findWinningLineThrough(std::uint64_t move, std::uint64_t discs) {
+        for (unsigned int shift: bitBoard.lineShifts()) {
+            const std::uint64_t anchors = BitBoard::fourAnchors(discs, shift)
+                                          & (move | move >> shift | move >> 2 * shift | move >> 3 * shift);
+            if (anchors == 0) continue;
+            // going towards higher bits goes to the right, or up in a column
+            const unsigned int first = std::countr_zero(anchors);
+            for (unsigned int k = 0; k < 4; k++) {
+                winningCells[k] = cellIndex(first + k * shift);
+            }
+            std::sort(winningCells.begin(), winningCells.end());
+            return true;
+        }
+        return false;
+    }
+
+public:
+    /**
+     * @throws std::invalid_argument if the board of the game doesn't fit in a BitBoard
+     */
+    explicit Power4Position(const Power4Game &game)
+            : bitBoard(game.getBitBoard() != nullptr ? *game.getBitBoard() : throw std::invalid_argument(
+                    "only the boards that fit in 64 bits have positions")),
+              hash(game.getHash()), alignments(game.getAlignments()), moveCount(game.getMoveCount()),
+              won(game.hasWinner()), winningCells() {
+        std::span<const unsigned int> cells = game.getWinningCells();
+        std::copy(cells.begin(), cells.end(), winningCells.begin());
+    }
+
+    [[nodiscard]] unsigned int getWidth() const {
+        return bitBoard.getWidth();
+    }
+
+    [[nodiscard]] unsigned int getHeight() const {
+        return bitBoard.getHeight();
+    }
+
+    /**
+     * @tparam Access CheckedAccess to throw an OutOfRangeException if x or y is out of range, UncheckedAccess if they
+     * are known to be in range
+     */
+    template<typename Access = CheckedAccess>
+    [[nodiscard]] Power4Player get(unsigned int x, unsigned int y) const {
+        Access::check(x, y, getWidth(), getHeight());
+        return static_cast<Power4Player>('0' + bitBoard.getBit(bitIndex(x, y)));
+    }
+
+    [[nodiscard]] unsigned int getColumnHeight(unsigned int column) const {
+        if (column >= getWidth()) {
+            throw std::out_of_range("column out of range");
+        }
+        const std::uint64_t columnCells = ((std::uint64_t{1} << getHeight()) - 1) << (column * (getHeight() + 1));
+        return std::popcount(bitBoard.occupied() & columnCells);
+    }
+
+    [[nodiscard]] unsigned int getMoveCount() const {
+        return moveCount;
+    }
+
+    [[nodiscard]] const BitBoard &getBitBoard() const {
+        return bitBoard;
+    }
+
+    [[nodiscard]] std::uint64_t getHash() const {
+        return hash;
+    }
+
+    [[nodiscard]] bool isDraw() const {
+        return bitBoard.isFull();
+    }
+
+    [[nodiscard]] bool hasWinner() const {
+        return won;
+    }
+
+    [[nodiscard]] std::optional<Power4Player> getOptionalWinner() const {
+        if (!won) return std::nullopt;
+        return get<UncheckedAccess>(winningCells[0] % getWidth(), winningCells[0] / getWidth());
+    }
+
+    /**
+     * @return the cells of the winning line, valid as long as this position, empty if no winner
+     */
+    [[nodiscard]] std::span<const unsigned int> getWinningCells() const {
+        if (!won) return {};
+        return winningCells;
+    }
+
+    [[nodiscard]] double getScore(const Power4Player &player) const {
+        if (won) return Power4Game::winScore(*getOptionalWinner());
+        return Power4Game::scoreOf(alignments, player);
+    }
+
+    /**
+     * @return the position after player drops a disc in a column, std::nullopt if the column is full. Like in
+     * Power4Game, the winner stays the first one even if the game goes on.
+     * @throws std::invalid_argument if player isn't '1' or '2'
+     * @throws std::out_of_range if the column is out of range
+     */
+    [[nodiscard]] std::optional<Power4Position> afterMove(unsigned int column, Power4Player player) const {
+        if (player != '1' && player != '2') {
+            throw std::invalid_argument("player must be 1 or 2");
+        }
+        if (column >= getWidth()) {
+            throw std::out_of_range("column out of range");
+        }
+        if (!bitBoard.canPlay(column)) return std::nullopt;
+        const unsigned int playerIndex = player == '1' ? 0 : 1;
+        Power4Position next = *this;
+        const std::uint64_t move = next.bitBoard.play(column, playerIndex);
+        const unsigned int y = getHeight() - 1 - static_cast<unsigned int>(std::countr_zero(move)) % (getHeight() + 1);
+        next.hash ^= Power4Game::zobristKey(y * getWidth() + column, player);
+        next.alignments = countBitBoardAlignments(next.bitBoard.discs(0), next.bitBoard.occupied(),
+                                                  next.bitBoard.getBoardMask(), getHeight());
+        next.moveCount++;
+        if (!won) next.won = next.findWinningLineThrough(move, next.bitBoard.discs(playerIndex));
+        return next;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<Power4Position>);
+
+
+#endif //POWER4_POWER4POSITION_HPP
@@ -0,0 +1,169 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_TICTACTOE_HPP
+#define POWER4_TICTACTOE_HPP
+
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include "Game.hpp"
+
+/**
+ * 'X' or 'O', '.' for an empty cell
+ */
+typedef char TicTacToePlayer;
+
+/**
+ * Tic-tac-toe on a 3x3 grid, a second SearchableGame next to Power4Game. The cells are numbered from 0 to 8 row by
+ * row, cell y * 3 + x being bit y * 3 + x of the marks of each player.
+ */
+class TicTacToe final : public Game<TicTacToePlayer> {
+public:
+    static constexpr unsigned int CELLS = 9;
+
+private:
+    static constexpr std::array<std::uint16_t, 8> LINES = {
+            0b000'000'111, 0b000'111'000, 0b111'000'000, // rows
+            0b001'001'001, 0b010'010'010, 0b100'100'100, // columns
+            0b100'010'001, 0b001'010'100, // diagonals
+    };
+    static constexpr double WIN_SCORE = std::numeric_limits<double>::infinity();
+
+    std::array<std::uint16_t, 2> marks{}; // of 'X' and 'O'
+    std::array<std::uint8_t, CELLS> moves{};
+    unsigned int moveCount = 0;
+
+    static unsigned int indexOf(TicTacToePlayer player) {
+        return player == 'X' ? 0 : 1;
+    }
+
+    /**
+     * Bit i is set if the cells i contain a line, for each of the 512 sets of cells
+     */
+    static constexpr std::array<std::uint64_t, 8> HAS_LINE = [] {
+        std::array<std::uint64_t, 8> hasLine{};
+        for (unsigned int cells = 0; cells < 512; cells++) {
+            for (std::uint16_t line: LINES) {
+                if ((cells & line) == line) hasLine[cells / 64] |= std::uint64_t{1} << cells % 64;
+            }
+        }
+        return hasLine;
+    }();
+
+    static bool hasLine(std::uint16_t cells) {
+        return HAS_LINE[cells / 64] >> cells % 64 & 1;
+    }
+
+    /**
+     * @return the number of lines that still have no mark of the opponent but have one of the player
+     */
+    static unsigned int countOpenLines(std::uint16_t cells, std::uint16_t opponentCells) {
+        unsigned int count = 0;
+        for (std::uint16_t line: LINES) {
+            count += (cells & line) != 0 && (opponentCells & line) == 0;
+        }
+        return count;
+    }
+
+public:
+    /**
+     * @return the mark in a cell, '.' if it is empty
+     * @throws std::out_of_range if the cell is outside the grid
+     */
+    [[nodiscard]] TicTacToePlayer get(unsigned int x, unsigned int y) const {
+        if (x >= 3 || y >= 3) {
+            throw std::out_of_range("cell out of range");
+        }
+        const unsigned int bit = y * 3 + x;
+        if (marks[0] >> bit & 1) return 'X';
+        if (marks[1] >> bit & 1) return 'O';
+        return '.';
+    }
+
+    [[nodiscard]] unsigned int getMoveCount() const {
+        return moveCount;
+    }
+
+    /**
+     * Marks a cell, returns true if successful, false if it is already marked
+     */
+    bool play(unsigned int cell, TicTacToePlayer player) {
+        if (player != 'X' && player != 'O') {
+            throw std::invalid_argument("player must be X or O");
+        }
+        if (cell >= CELLS) {
+            throw std::out_of_range("cell out of range");
+        }
+        const std::uint16_t bit = 1 << cell;
+        if ((marks[0] | marks[1]) & bit) return false;
+        marks[indexOf(player)] |= bit;
+        moves[moveCount++] = static_cast<std::uint8_t>(cell);
+        return true;
+    }
+
+    /**
+     * Removes the last mark added
+     * @return false if there is no mark to remove
+     */
+    bool undo() {
+        if (moveCount == 0) return false;
+        const std::uint16_t bit = ~(1 << moves[--moveCount]);
+        marks[0] &= bit;
+        marks[1] &= bit;
+        return true;
+    }
+
+    [[nodiscard]] static TicTacToePlayer opponentOf(TicTacToePlayer player) {
+        return player == 'X' ? 'O' : 'X';
+    }
+
+    [[nodiscard]] unsigned int getMoveSlots() const {
+        return CELLS;
+    }
+
+    /**
+     * Infinite for the winner, otherwise the number of lines the player can still complete minus the ones of the
+     * opponent
+     */
+    [[nodiscard]] double getScore(const TicTacToePlayer &player) const override {
+        const unsigned int index = indexOf(player);
+        if (hasLine(marks[index])) return WIN_SCORE;
+        if (hasLine(marks[1 - index])) return -WIN_SCORE;
+        return static_cast<double>(countOpenLines(marks[index], marks[1 - index]))
+               - static_cast<double>(countOpenLines(marks[1 - index], marks[index]));
+    }
+
+    [[nodiscard]] std::vector<TicTacToePlayer> getPlayers() const override {
+        return {'X', 'O'};
+    }
+
+    [[nodiscard]] bool hasWinner() const {
+        return hasLine(marks[0]) || hasLine(marks[1]);
+    }
+
+    [[nodiscard]] bool isDraw() const override {
+        return moveCount == CELLS && !hasWinner();
+    }
+
+    [[nodiscard]] std::optional<TicTacToePlayer> getOptionalWinner() const override {
+        if (hasLine(marks[0])) return 'X';
+        if (hasLine(marks[1])) return 'O';
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::unique_ptr<TicTacToePlayer> getWinner() const override {
+        std::optional<TicTacToePlayer> winner = getOptionalWinner();
+        if (!winner) return {nullptr};
+        return std::make_unique<TicTacToePlayer>(*winner);
+    }
+};
+
+
+#endif //POWER4_TICTACTOE_HPP
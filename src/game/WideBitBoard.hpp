@@ -0,0 +1,274 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_WIDEBITBOARD_HPP
+#define POWER4_WIDEBITBOARD_HPP
+
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <variant>
+#include "BitBoard.hpp"
+#include "AlignmentKernels.hpp"
+
+/**
+ * A mask of Words * 64 bits, bit i being bit i % 64 of word i / 64
+ */
+template<unsigned int Words>
+struct WideMask {
+    std::array<std::uint64_t, Words> words{};
+
+    [[nodiscard]] constexpr bool test(unsigned int index) const {
+        return words[index / 64] >> index % 64 & 1;
+    }
+
+    constexpr void set(unsigned int index) {
+        words[index / 64] |= std::uint64_t{1} << index % 64;
+    }
+
+    constexpr void reset(unsigned int index) {
+        words[index / 64] &= ~(std::uint64_t{1} << index % 64);
+    }
+
+    constexpr bool operator==(const WideMask &other) const = default;
+
+    friend constexpr WideMask operator^(WideMask a, const WideMask &b) {
+        for (unsigned int i = 0; i < Words; i++) a.words[i] ^= b.words[i];
+        return a;
+    }
+
+    /**
+     * The number of bits set
+     */
+    friend constexpr int bitCount(const WideMask &mask) {
+        int count = 0;
+        for (std::uint64_t word: mask.words) count += std::popcount(word);
+        return count;
+    }
+};
+
+/**
+ * The 4 lines through a cell, from 5 cells before it to 5 cells after it, which are all the cells of the lines counted by
+ * Power4Game::getScore that go through it. Each line takes 16 bits, in the order of alignmentShifts, the cell being
+ * bit 5 of its line. The cells outside the board and the bits between the lines are neither discs nor empty, so the
+ * kernels of AlignmentKernels.hpp count these lines with a shift of 1 like they count a whole board.
+ */
+struct CellLines {
+    static constexpr std::uint64_t CELL = 0x0020'0020'0020'0020; // bit 5 of each line
+
+    std::array<std::uint64_t, 2> discs{}; // of each player
+    std::uint64_t empty = 0;
+
+    /**
+     * @return the same lines with a disc of a player in the cell, which must be empty
+     */
+    [[nodiscard]] constexpr CellLines withDisc(unsigned int playerIndex) const {
+        CellLines lines = *this;
+        lines.discs[playerIndex] |= CELL;
+        lines.empty &= ~CELL;
+        return lines;
+    }
+
+    /**
+     * @return true if a player has 4 aligned discs in these lines
+     */
+    [[nodiscard]] constexpr bool hasFour(unsigned int playerIndex) const {
+        return BitBoard::fourAnchors(discs[playerIndex], 1) != 0;
+    }
+};
+
+POWER4_KERNEL_INLINE constexpr Alignments countCellLinesPortable(const CellLines &lines) {
+    Alignments alignments;
+    for (unsigned int player = 0; player < 2; player++) {
+        countLineAlignments(lines.discs[player], lines.empty, 1, alignments.aligns2[player], alignments.aligns3[player]);
+    }
+    return alignments;
+}
+
+#ifdef POWER4_X86_KERNELS
+
+__attribute__((target("popcnt")))
+inline Alignments countCellLinesPopcnt(const CellLines &lines) {
+    return countCellLinesPortable(lines);
+}
+
+#endif
+
+typedef Alignments (*CellLinesCounter)(const CellLines &lines);
+
+/**
+ * @return the fastest version of countCellLines supported by this CPU
+ */
+inline CellLinesCounter bestCellLinesCounter() {
+#ifdef POWER4_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt")) return &countCellLinesPopcnt;
+#endif
+    return &countCellLinesPortable;
+}
+
+/**
+ * Counts the alignments of CellLines, mostly popcounts like countBitBoardAlignments
+ */
+inline const CellLinesCounter countCellLines = bestCellLinesCounter();
+
+/**
+ * A BitBoard for the boards that don't fit in 64 bits, with the same layout (column by column from the bottom, with
+ * an empty bit on top of each column) spread over Words 64-bit words. The lines are found with the shifts of BitBoard
+ * on the CellLines of each move rather than on the whole board, whose cost grows with Words. Only used for the boards
+ * that don't fit in a smaller one, see fits.
+ */
+template<unsigned int Words>
+class WideBitBoard {
+public:
+    typedef WideMask<Words> Mask;
+
+private:
+    unsigned int width, height;
+    Mask boardMask; // all the playable cells
+    Mask player1; // discs of the first player
+    Mask mask; // discs of both players
+
+public:
+    /**
+     * @return true if a board of this size fits in Words words
+     */
+    static constexpr bool fits(unsigned int width, unsigned int height) {
+        return width * (height + 1) <= 64 * Words;
+    }
+
+    WideBitBoard(unsigned int width, unsigned int height) : width(width), height(height) {
+        for (unsigned int x = 0; x < width; x++) {
+            for (unsigned int row = 0; row < height; row++) {
+                boardMask.set(x * (height + 1) + row);
+            }
+        }
+    }
+
+    [[nodiscard]] unsigned int getWidth() const {
+        return width;
+    }
+
+    [[nodiscard]] unsigned int getHeight() const {
+        return height;
+    }
+
+    /**
+     * @return the discs of a player, 0 being the first player and 1 the second one
+     */
+    [[nodiscard]] Mask discs(unsigned int playerIndex) const {
+        return playerIndex == 0 ? player1 : player1 ^ mask;
+    }
+
+    [[nodiscard]] const Mask &occupied() const {
+        return mask;
+    }
+
+    [[nodiscard]] const Mask &getBoardMask() const {
+        return boardMask;
+    }
+
+    /**
+     * @return 0 if the cell is empty, 1 for the first player, 2 for the second one
+     */
+    [[nodiscard]] unsigned int get(unsigned int x, unsigned int row) const {
+        return getBit(x * (height + 1) + row);
+    }
+
+    /**
+     * Like get, given the index of the bit of the cell
+     */
+    [[nodiscard]] unsigned int getBit(unsigned int index) const {
+        if (!mask.test(index)) return 0;
+        return player1.test(index) ? 1 : 2;
+    }
+
+    /**
+     * Drops a disc in a column, on top of the row discs already in it: unlike BitBoard, the heights of the columns
+     * are given, as finding them takes several words.
+     * @return the index of the bit of the new disc
+     */
+    unsigned int play(unsigned int column, unsigned int row, unsigned int playerIndex) {
+        const unsigned int index = column * (height + 1) + row;
+        mask.set(index);
+        if (playerIndex == 0) player1.set(index);
+        return index;
+    }
+
+    /**
+     * Removes the top disc of a column, which is in the given row
+     */
+    void undo(unsigned int column, unsigned int row) {
+        const unsigned int index = column * (height + 1) + row;
+        mask.reset(index);
+        player1.reset(index);
+    }
+
+    [[nodiscard]] bool isFull() const {
+        return mask == boardMask;
+    }
+
+    /**
+     * @return the lines through a cell, read bit by bit: unlike the shifts of the whole board, this doesn't depend on
+     * its size
+     */
+    [[nodiscard]] CellLines linesThrough(unsigned int x, unsigned int row) const {
+        // the steps of alignmentShifts in columns and rows
+        static constexpr std::array<std::array<int, 2>, 4> steps = {{{1, 0}, {0, -1}, {1, -1}, {1, 1}}};
+        CellLines lines;
+        for (unsigned int line = 0; line < 4; line++) {
+            const auto &[dx, dRow] = steps[line];
+            for (int k = -5; k <= 5; k++) {
+                const int cellX = static_cast<int>(x) + k * dx, cellRow = static_cast<int>(row) + k * dRow;
+                if (cellX < 0 || cellX >= static_cast<int>(width) || cellRow < 0 || cellRow >= static_cast<int>(height)) {
+                    continue;
+                }
+                const unsigned int index = cellX * (height + 1) + cellRow;
+                const std::uint64_t occupiedBit = mask.test(index), player1Bit = player1.test(index);
+                const unsigned int position = 16 * line + 5 + k;
+                lines.discs[0] |= player1Bit << position;
+                lines.discs[1] |= (occupiedBit & ~player1Bit) << position;
+                lines.empty |= (occupiedBit ^ 1) << position;
+            }
+        }
+        return lines;
+    }
+
+    [[nodiscard]] unsigned int countDiscs() const {
+        return bitCount(mask);
+    }
+};
+
+/**
+ * The WideBitBoard of the smallest size a board fits in, or std::monostate if it fits in a BitBoard or is larger than
+ * the largest one
+ */
+typedef std::variant<std::monostate, WideBitBoard<2>, WideBitBoard<4>, WideBitBoard<8>> AnyWideBitBoard;
+
+inline AnyWideBitBoard makeWideBitBoard(unsigned int width, unsigned int height) {
+    if (BitBoard::fits(width, height)) return std::monostate{};
+    if (WideBitBoard<2>::fits(width, height)) return WideBitBoard<2>(width, height);
+    if (WideBitBoard<4>::fits(width, height)) return WideBitBoard<4>(width, height);
+    if (WideBitBoard<8>::fits(width, height)) return WideBitBoard<8>(width, height);
+    return std::monostate{};
+}
+
+/**
+ * @return f called with the WideBitBoard of board, which must not be std::monostate
+ */
+template<typename AnyBoard, typename F>
+decltype(auto) visitWideBitBoard(AnyBoard &board, F &&f) {
+    switch (board.index()) {
+        case 1:
+            return f(*std::get_if<1>(&board));
+        case 2:
+            return f(*std::get_if<2>(&board));
+        default:
+            return f(*std::get_if<3>(&board));
+    }
+}
+
+
+#endif //POWER4_WIDEBITBOARD_HPP
@@ -1,35 +1,87 @@
 #include <iostream>
+#include <optional>
+#include <string>
 #include "game/Power4Game.hpp"
+#include "ai/AlphaBetaSearch.hpp"
+#include "ai/MonteCarloSearch.hpp"
 
-int main() {
+/**
+ * Usage: Power4 [--ai [depth] | --mcts [playouts]] [--think <milliseconds>] [--book <file>]
+ *
+ * With --ai, the second player is played by the computer, searching at the given depth (10 by default).
+ * With --mcts, the computer runs a Monte Carlo tree search with the given number of playouts (100000 by default).
+ * With --think, the computer searches as much as it can in the given time (with alpha-beta unless --mcts is given).
+ * With --book, the alpha-beta computer plays the moves of an opening book made by Power4Book when it knows the
+ * position.
+ */
+int main(int argc, char *argv[]) {
     try {
+        std::unique_ptr<Engine> computer;
+        AlphaBetaSearch *alphaBeta = nullptr; // the computer, if it is an alpha-beta search
+        std::optional<std::chrono::milliseconds> thinkTime;
+        std::shared_ptr<const OpeningBook> book;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0;
+            if (arg == "--ai") {
+                computer = std::make_unique<AlphaBetaSearch>(hasValue ? std::stoul(argv[++i]) : 10);
+            } else if (arg == "--mcts") {
+                computer = std::make_unique<MonteCarloSearch>(hasValue ? std::stoull(argv[++i]) : 100000);
+            } else if (arg == "--think" && hasValue) {
+                thinkTime = std::chrono::milliseconds(std::stoul(argv[++i]));
+            } else if (arg == "--book" && hasValue) {
+                book = std::make_shared<const OpeningBook>(argv[++i]);
+            }
+        }
+        if (thinkTime && !computer) computer = std::make_unique<AlphaBetaSearch>(AlphaBetaSearch::MAX_DEPTH);
+        alphaBeta = dynamic_cast<AlphaBetaSearch *>(computer.get());
+        if (alphaBeta != nullptr) alphaBeta->setOpeningBook(book);
+
         Power4Game board;
-        std::unique_ptr<unsigned char> winner = nullptr;
+        std::optional<Power4Player> winner;
         unsigned long players = board.getPlayers().size();
         Power4Player currentPlayer = board.getPlayers().at(0);
 
         board.print();
 
         do {
-            char columnLetter;
-            std::cout << std::endl << "Player " << currentPlayer << ", enter a columnLetter: ";
-            std::cin >> columnLetter;
-            unsigned int column = columnLetter - 'A';
-            if (column >= board.getWidth()) {
-                std::cout << "Invalid columnLetter" << std::endl;
-                continue;
+            unsigned int column;
+            if (computer && currentPlayer == '2') {
+                SearchResult result = thinkTime ? computer->think(board, currentPlayer, *thinkTime)
+                                                : computer->search(board, currentPlayer);
+                column = result.column;
+                // the nodes of a Monte Carlo search are its playouts
+                const char *nodes = alphaBeta != nullptr ? " nodes" : " playouts";
+                std::cout << std::endl << "Computer plays " << static_cast<char>('A' + column) << " (score "
+                          << result.score << ", depth " << result.depth << ", " << result.nodes << nodes << " in "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(result.elapsed).count() << " ms, "
+                          << static_cast<unsigned long>(result.nodesPerSecond()) << nodes << "/s";
+                if (alphaBeta != nullptr) {
+                    std::cout << ", " << std::format("{:.1f}", 100 * alphaBeta->getTableStats().hitRate())
+                              << "% TT hits";
+                }
+                std::cout << ")" << std::endl;
+            } else {
+                char columnLetter;
+                std::cout << std::endl << "Player " << currentPlayer << ", enter a columnLetter: ";
+                std::cin >> columnLetter;
+                column = columnLetter - 'A';
+                if (column >= board.getWidth()) {
+                    std::cout << "Invalid columnLetter" << std::endl;
+                    continue;
+                }
             }
             if (!board.addInColumn(column, currentPlayer)) {
                 std::cout << "Column full" << std::endl;
                 continue;
             }
-            winner = board.getWinner();
+            winner = board.getOptionalWinner();
             currentPlayer = (currentPlayer % players) + '1';
             board.print();
-        } while (!board.isDraw() && winner == nullptr);
+        } while (!board.isDraw() && !winner);
 
         std::cout << std::endl;
-        if (winner == nullptr) {
+        if (!winner) {
             std::cout << "Draw" << std::endl;
         } else {
             std::cout << "Winner: player " << *winner << std::endl;
@@ -41,5 +93,8 @@ int main() {
         std::cerr << "Error: " << e.what() << std::endl;
         e.printTrace();
         return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
 }
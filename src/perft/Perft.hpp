@@ -0,0 +1,248 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_PERFT_HPP
+#define POWER4_PERFT_HPP
+
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../util/MathUtils.hpp"
+
+struct PerftOptions {
+    unsigned int threads = 1; // 0 for one per hardware thread
+    /**
+     * Size of the table of the counts of the subtrees already counted, so that the positions reached by several move
+     * orders are only counted once. 0 to count every subtree.
+     */
+    std::size_t tableBytes = 0;
+    /**
+     * The positions this many plies after the start are the tasks shared between the threads. More tasks balance the
+     * threads better, but each one costs a copy of the game.
+     */
+    unsigned int splitPlies = 3;
+};
+
+struct PerftResult {
+    std::uint64_t leaves = 0; // move sequences of the given depth, the number perft is about
+    std::uint64_t nodes = 0; // moves played, not counting the subtrees found in the table
+    std::uint64_t tableHits = 0;
+    std::uint64_t tasks = 0;
+    std::uint64_t steals = 0; // tasks run by another thread than the one that created them
+    std::chrono::nanoseconds elapsed{0};
+
+    PerftResult &operator+=(const PerftResult &other) {
+        leaves += other.leaves;
+        nodes += other.nodes;
+        tableHits += other.tableHits;
+        tasks += other.tasks;
+        steals += other.steals;
+        return *this;
+    }
+
+    /**
+     * @return the moves played per second, to measure the move generation
+     */
+    [[nodiscard]] double nodesPerSecond() const {
+        return elapsed.count() == 0 ? 0 : static_cast<double>(nodes) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * Counts of subtrees by position and depth, shared by all the threads without locks.
+ *
+ * Each slot holds the data (count and depth) and the key xor the data: a slot torn by two threads writing at once
+ * doesn't match its key anymore, so it is only a miss.
+ */
+class PerftTable {
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    static constexpr unsigned int DEPTH_BITS = 6;
+
+    std::vector<Slot> slots;
+    std::uint64_t indexMask;
+
+public:
+    /**
+     * @param bytes rounded down to a power of 2 of slots
+     */
+    explicit PerftTable(std::size_t bytes)
+            : slots(std::bit_floor(bytes / sizeof(Slot) == 0 ? 1 : bytes / sizeof(Slot))),
+              indexMask(slots.size() - 1) {}
+
+    /**
+     * Keys must differ for different positions, and not be 0
+     */
+    [[nodiscard]] std::optional<std::uint64_t> probe(std::uint64_t key, unsigned int depth) const {
+        const Slot &slot = slots[splitMix64(key) & indexMask];
+        const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) != key) return std::nullopt;
+        if ((data & ((1 << DEPTH_BITS) - 1)) != depth) return std::nullopt;
+        return data >> DEPTH_BITS;
+    }
+
+    void store(std::uint64_t key, unsigned int depth, std::uint64_t count) {
+        if (depth >= 1 << DEPTH_BITS || count >> (64 - DEPTH_BITS) != 0) return;
+        Slot &slot = slots[splitMix64(key) & indexMask];
+        const std::uint64_t data = count << DEPTH_BITS | depth;
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return a key of the position for probe and store. The BitBoard key is unique, the Zobrist hash of larger
+     * boards only almost.
+     */
+    [[nodiscard]] static std::uint64_t keyOf(const Power4Game &game) {
+        const BitBoard *bitBoard = game.getBitBoard();
+        const std::uint64_t key = bitBoard != nullptr ? bitBoard->key() : game.getHash();
+        return key == 0 ? 1 : key;
+    }
+};
+
+/**
+ * Counts the move sequences of depth moves from a position, the players alternating, a sequence stopping when a
+ * player wins. The game is left as it was.
+ * @param table to reuse the counts of the positions already seen, can be nullptr
+ */
+inline std::uint64_t perft(Power4Game &game, unsigned int depth, PerftTable *table, PerftResult &counters) {
+    if (depth == 0) return 1;
+    if (game.hasWinner() || game.isDraw()) return 0;
+    std::uint64_t key = 0;
+    if (table != nullptr && depth >= 2) {
+        key = PerftTable::keyOf(game);
+        if (std::optional<std::uint64_t> count = table->probe(key, depth)) {
+            counters.tableHits++;
+            return *count;
+        }
+    }
+    const Power4Player player = game.getMoveCount() % 2 == 0 ? '1' : '2';
+    std::uint64_t count = 0;
+    for (unsigned int column = 0; column < game.getWidth(); column++) {
+        if (!game.addInColumn(column, player)) continue;
+        counters.nodes++;
+        count += perft(game, depth - 1, table, counters);
+        game.undo();
+    }
+    if (key != 0) table->store(key, depth, count);
+    return count;
+}
+
+/**
+ * Runs perft on several threads. The positions options.splitPlies plies after the start are tasks: each thread pushes
+ * the tasks it creates at the back of its own queue and takes the next one there (depth first, to keep few tasks
+ * alive), and when it has none left it steals the oldest task of another thread, which is the largest.
+ */
+inline PerftResult runPerft(const Power4Game &start, unsigned int depth, const PerftOptions &options = {}) {
+    const auto startTime = std::chrono::steady_clock::now();
+    unsigned int threadCount = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    std::optional<PerftTable> table;
+    if (options.tableBytes != 0) table.emplace(options.tableBytes);
+
+    struct Task {
+        Power4Game game;
+        unsigned int depth;
+        unsigned int ply; // since the start
+    };
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<TaskQueue> queues(threadCount);
+    queues[0].tasks.push_back({start, depth, 0});
+    std::atomic<std::uint64_t> pendingTasks = 1; // queued or running
+    std::vector<PerftResult> threadResults(threadCount);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    std::atomic<bool> stop = false;
+
+    auto work = [&](unsigned int index) {
+        PerftResult result; // local, so that the threads don't write to the same cache lines
+        try {
+            while (pendingTasks.load() > 0 && !stop.load(std::memory_order_relaxed)) {
+                std::optional<Task> task;
+                {
+                    std::lock_guard lock(queues[index].mutex);
+                    if (!queues[index].tasks.empty()) {
+                        task.emplace(std::move(queues[index].tasks.back()));
+                        queues[index].tasks.pop_back();
+                    }
+                }
+                for (unsigned int i = 1; !task && i < threadCount; i++) {
+                    TaskQueue &victim = queues[(index + i) % threadCount];
+                    std::lock_guard lock(victim.mutex);
+                    if (!victim.tasks.empty()) {
+                        task.emplace(std::move(victim.tasks.front()));
+                        victim.tasks.pop_front();
+                        result.steals++;
+                    }
+                }
+                if (!task) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                result.tasks++;
+                Power4Game &game = task->game;
+                if (task->ply < options.splitPlies && task->depth > 1 && !game.hasWinner() && !game.isDraw()) {
+                    const Power4Player player = game.getMoveCount() % 2 == 0 ? '1' : '2';
+                    for (unsigned int column = 0; column < game.getWidth(); column++) {
+                        if (!game.addInColumn(column, player)) continue;
+                        result.nodes++;
+                        pendingTasks++;
+                        {
+                            std::lock_guard lock(queues[index].mutex);
+                            queues[index].tasks.push_back({game, task->depth - 1, task->ply + 1});
+                        }
+                        game.undo();
+                    }
+                } else {
+                    result.leaves += perft(game, task->depth, table ? &*table : nullptr, result);
+                }
+                pendingTasks--;
+            }
+        } catch (...) {
+            std::lock_guard lock(errorMutex);
+            if (!error) error = std::current_exception();
+            stop = true;
+        }
+        threadResults[index] = result;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; i++) {
+        threads.emplace_back(work, i);
+    }
+    work(0);
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    if (error) std::rethrow_exception(error);
+
+    PerftResult total;
+    for (const PerftResult &result: threadResults) {
+        total += result;
+    }
+    total.elapsed = std::chrono::steady_clock::now() - startTime;
+    return total;
+}
+
+
+#endif //POWER4_PERFT_HPP
@@ -0,0 +1,66 @@
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include "Perft.hpp"
+
+/**
+ * Usage: Power4Perft [--size WxH] [--threads n] [--table-mb n] [--split n] depth
+ *
+ * Counts the move sequences from the empty board for each depth up to the given one, see perft, and prints the
+ * number of moves played per second. --table-mb counts each position only once per depth, with a table of that size,
+ * and --split sets PerftOptions::splitPlies.
+ */
+int main(int argc, char *argv[]) {
+    try {
+        PerftOptions options;
+        unsigned int width = 7, height = 6;
+        std::optional<unsigned int> depth;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) {
+                depth = std::stoul(arg);
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value after " << arg << std::endl;
+                return 2;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--threads") options.threads = std::stoul(value);
+            else if (arg == "--table-mb") options.tableBytes = std::stoull(value) << 20;
+            else if (arg == "--split") options.splitPlies = std::stoul(value);
+            else if (arg == "--size") {
+                const std::size_t x = value.find('x');
+                if (x == std::string::npos) throw std::invalid_argument("the size must look like 7x6");
+                width = std::stoul(value.substr(0, x));
+                height = std::stoul(value.substr(x + 1));
+            } else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return 2;
+            }
+        }
+        if (!depth) {
+            std::cerr << "Usage: Power4Perft [--size WxH] [--threads n] [--table-mb n] [--split n] depth" << std::endl;
+            return 2;
+        }
+
+        const Power4Game start(static_cast<int>(width), static_cast<int>(height));
+        for (unsigned int d = 1; d <= *depth; d++) {
+            const PerftResult result = runPerft(start, d, options);
+            std::cout << std::format("perft {:>2} {:>16} {:>14} nodes {:>10.1f} ms {:>12.0f} nodes/s", d, result.leaves,
+                                     result.nodes, static_cast<double>(result.elapsed.count()) / 1e6,
+                                     result.nodesPerSecond());
+            if (options.tableBytes != 0) std::cout << std::format(" {:>12} table hits", result.tableHits);
+            std::cout << std::endl;
+        }
+        return 0;
+    } catch (const TracedException &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        e.printTrace();
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
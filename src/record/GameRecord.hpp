@@ -0,0 +1,468 @@
+//
+// Created by bananasmoothii on 17/10/2026.
+//
+
+#ifndef POWER4_GAMERECORD_HPP
+#define POWER4_GAMERECORD_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../util/MappedFile.hpp"
+
+/*
+ * Files of played games, written by GameRecordWriter and read by GameRecordReader.
+ *
+ * Format (little endian): a RecordHeader, then blocks of at most gamesPerBlock games, then the index of the blocks
+ * (one RecordBlockIndex each) and a RecordFooter at the very end. Each block is a RecordBlockHeader followed by its
+ * games: one byte for the number of moves, one byte for the result (see RecordedGame::getResult), and the columns
+ * played, bitsPerPly bits each, the first one in the lowest bits of the first byte. Each game starts on a new byte.
+ *
+ * bitsPerPly is the fewest bits that hold a column: 2 for 4 columns, 3 up to 8, 4 up to 16. A 7x6 game takes 18 bytes
+ * at most. The index starts on a multiple of 8 bytes, after some padding.
+ */
+
+struct RecordHeader {
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint32_t width, height;
+    std::uint32_t bitsPerPly;
+    std::uint32_t gamesPerBlock;
+};
+static_assert(sizeof(RecordHeader) == 24);
+
+struct RecordBlockHeader {
+    std::uint32_t gameCount;
+    std::uint32_t bytes; // of the games, after this header
+};
+static_assert(sizeof(RecordBlockHeader) == 8);
+
+struct RecordBlockIndex {
+    std::uint64_t offset; // of the RecordBlockHeader from the start of the file
+    std::uint64_t firstGame; // index of the first game of the block
+};
+static_assert(sizeof(RecordBlockIndex) == 16);
+
+struct RecordFooter {
+    std::uint64_t indexOffset;
+    std::uint64_t blockCount;
+    std::uint64_t gameCount;
+    std::array<char, 4> magic;
+    std::uint32_t padding;
+};
+static_assert(sizeof(RecordFooter) == 32);
+
+/**
+ * The largest number of columns the column string notation and the records hold
+ */
+inline constexpr unsigned int MAX_RECORD_COLUMNS = 16;
+
+/**
+ * @return the column string notation of moves: the columns numbered from 1, like "4453", then from a for the tenth one
+ * up to g for the sixteenth one, or "-" if there are no moves
+ * @throws std::invalid_argument if a column is above 15
+ */
+inline std::string toColumnString(std::span<const std::uint8_t> columns) {
+    if (columns.empty()) return "-";
+    std::string moves(columns.size(), '0');
+    for (std::size_t i = 0; i < columns.size(); i++) {
+        if (columns[i] >= MAX_RECORD_COLUMNS) throw std::invalid_argument("only the first 16 columns have a character");
+        moves[i] = static_cast<char>(columns[i] < 9 ? '1' + columns[i] : 'a' + (columns[i] - 9));
+    }
+    return moves;
+}
+
+/**
+ * Reverse of toColumnString, without checking that the moves can be played
+ * @throws std::invalid_argument if a character isn't a column of a board of this width
+ */
+inline std::vector<std::uint8_t> parseColumnString(const std::string &moves, unsigned int width) {
+    std::vector<std::uint8_t> columns;
+    if (moves == "-") return columns;
+    columns.reserve(moves.size());
+    for (char c: moves) {
+        unsigned int column = MAX_RECORD_COLUMNS;
+        if (c >= '1' && c <= '9') column = c - '1';
+        else if (c >= 'a' && c < static_cast<char>('a' + (MAX_RECORD_COLUMNS - 9))) column = 9 + (c - 'a');
+        if (column >= width || column >= MAX_RECORD_COLUMNS) {
+            throw std::invalid_argument(std::string("'") + c + "' is not a column of a board of width "
+                                        + std::to_string(width));
+        }
+        columns.push_back(static_cast<std::uint8_t>(column));
+    }
+    return columns;
+}
+
+/**
+ * A game of a GameRecordReader, pointing into its mapped file
+ */
+class RecordedGame {
+private:
+    const std::uint8_t *packed;
+    unsigned int plies;
+    unsigned int result;
+    unsigned int bitsPerPly;
+
+public:
+    RecordedGame(const std::uint8_t *packed, unsigned int plies, unsigned int result, unsigned int bitsPerPly)
+            : packed(packed), plies(plies), result(result), bitsPerPly(bitsPerPly) {}
+
+    /**
+     * @return the number of bytes of the columns of a game
+     */
+    [[nodiscard]] static std::size_t packedBytes(unsigned int plies, unsigned int bitsPerPly) {
+        return (plies * bitsPerPly + 7) / 8;
+    }
+
+    [[nodiscard]] unsigned int getPlyCount() const {
+        return plies;
+    }
+
+    /**
+     * @return 0 if the game wasn't over, 1 or 2 for the winner, 3 for a draw
+     */
+    [[nodiscard]] unsigned int getResult() const {
+        return result;
+    }
+
+    /**
+     * @return the column of a move, the first one being 0. ply must be below getPlyCount().
+     */
+    [[nodiscard]] unsigned int getColumn(unsigned int ply) const {
+        const unsigned int bit = ply * bitsPerPly;
+        unsigned int bits = packed[bit / 8];
+        if (bit % 8 + bitsPerPly > 8) bits |= packed[bit / 8 + 1] << 8;
+        return bits >> bit % 8 & ((1 << bitsPerPly) - 1);
+    }
+
+    /**
+     * Calls f with each column in order, faster than getColumn
+     */
+    template<typename F>
+    void forEachColumn(F &&f) const {
+        const std::uint8_t *next = packed;
+        std::uint64_t buffer = 0;
+        unsigned int buffered = 0;
+        const unsigned int mask = (1 << bitsPerPly) - 1;
+        for (unsigned int ply = 0; ply < plies; ply++) {
+            if (buffered < bitsPerPly) {
+                buffer |= static_cast<std::uint64_t>(*next++) << buffered;
+                buffered += 8;
+            }
+            f(static_cast<unsigned int>(buffer & mask));
+            buffer >>= bitsPerPly;
+            buffered -= bitsPerPly;
+        }
+    }
+
+    [[nodiscard]] std::vector<std::uint8_t> getColumns() const {
+        std::vector<std::uint8_t> columns;
+        columns.reserve(plies);
+        forEachColumn([&](unsigned int column) { columns.push_back(static_cast<std::uint8_t>(column)); });
+        return columns;
+    }
+
+    /**
+     * Plays the moves in a game of the size of the record, from its current position, see Power4Game::addInColumns
+     * @return false if a move couldn't be played, the game then stops before it
+     */
+    bool replay(Power4Game &game) const {
+        std::array<std::uint8_t, 255> columns; // only the first plies are set
+        bool valid = true;
+        unsigned int ply = 0;
+        forEachColumn([&](unsigned int column) {
+            valid &= column < game.getWidth();
+            columns[ply++] = static_cast<std::uint8_t>(column);
+        });
+        return valid && game.addInColumns(std::span(columns.data(), plies));
+    }
+
+    /**
+     * Plays the moves in a BitBoard, much faster than in a Power4Game when only the final position is needed. The
+     * moves must be valid, like the ones of a record written from played games.
+     */
+    void replay(BitBoard &bitBoard) const {
+        unsigned int player = bitBoard.countDiscs() % 2;
+        forEachColumn([&](unsigned int column) {
+            bitBoard.play(column, player);
+            player ^= 1;
+        });
+    }
+};
+
+/**
+ * Writes games to a record file as they come, one block at a time, so that the memory used doesn't depend on the
+ * number of games. The file is only complete once closed.
+ */
+class GameRecordWriter {
+public:
+    static constexpr std::array<char, 4> MAGIC = {'P', '4', 'G', 'R'};
+    static constexpr std::array<char, 4> FOOTER_MAGIC = {'P', '4', 'G', 'X'};
+    static constexpr std::uint32_t VERSION = 1;
+
+private:
+    std::string path;
+    std::ofstream out;
+    RecordHeader header;
+    std::vector<std::uint8_t> block;
+    std::uint32_t blockGames = 0;
+    std::vector<RecordBlockIndex> index;
+    std::uint64_t games = 0;
+    std::uint64_t offset = sizeof(RecordHeader);
+    bool closed = false;
+
+    void check() {
+        if (!out) throw std::runtime_error("cannot write " + path);
+    }
+
+    void writeBlock() {
+        if (blockGames == 0) return;
+        index.push_back({offset, games - blockGames});
+        const RecordBlockHeader blockHeader{blockGames, static_cast<std::uint32_t>(block.size())};
+        out.write(reinterpret_cast<const char *>(&blockHeader), sizeof(blockHeader));
+        out.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size()));
+        check();
+        offset += sizeof(blockHeader) + block.size();
+        block.clear();
+        blockGames = 0;
+    }
+
+public:
+    /**
+     * @throws std::invalid_argument if the games of this board size don't fit in the format
+     * @throws std::runtime_error if the file can't be written
+     */
+    GameRecordWriter(const std::string &path, unsigned int width, unsigned int height,
+                     std::uint32_t gamesPerBlock = 4096)
+            : path(path), out(path, std::ios::binary | std::ios::trunc),
+              header{MAGIC, VERSION, width, height, static_cast<std::uint32_t>(std::bit_width(width - 1)), gamesPerBlock} {
+        if (width < 4 || height < 4 || width > MAX_RECORD_COLUMNS || width * height > 255) {
+            throw std::invalid_argument("records only hold games of 4 to 16 columns and at most 255 cells");
+        }
+        if (gamesPerBlock == 0) throw std::invalid_argument("a block needs at least one game");
+        check();
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        check();
+        block.reserve(gamesPerBlock * (2 + RecordedGame::packedBytes(width * height, header.bitsPerPly)));
+    }
+
+    GameRecordWriter(const GameRecordWriter &) = delete;
+
+    GameRecordWriter &operator=(const GameRecordWriter &) = delete;
+
+    ~GameRecordWriter() {
+        try {
+            close();
+        } catch (const std::exception &) {
+            // close it explicitly to know if it failed
+        }
+    }
+
+    /**
+     * @param result see RecordedGame::getResult
+     * @throws std::invalid_argument if there are more moves than cells or a column is out of the board
+     */
+    void add(std::span<const std::uint8_t> columns, unsigned int result) {
+        if (closed) throw std::logic_error("the record is closed");
+        if (columns.size() > header.width * header.height || result > 3) {
+            throw std::invalid_argument("not a game of this record");
+        }
+        // checked before writing anything, so that a rejected game leaves the block as it was
+        for (std::uint8_t column: columns) {
+            if (column >= header.width) throw std::invalid_argument("column out of the board");
+        }
+        block.push_back(static_cast<std::uint8_t>(columns.size()));
+        block.push_back(static_cast<std::uint8_t>(result));
+        std::uint32_t buffer = 0;
+        unsigned int buffered = 0;
+        for (std::uint8_t column: columns) {
+            buffer |= static_cast<std::uint32_t>(column) << buffered;
+            buffered += header.bitsPerPly;
+            if (buffered >= 8) {
+                block.push_back(static_cast<std::uint8_t>(buffer));
+                buffer >>= 8;
+                buffered -= 8;
+            }
+        }
+        if (buffered > 0) block.push_back(static_cast<std::uint8_t>(buffer));
+        games++;
+        if (++blockGames == header.gamesPerBlock) writeBlock();
+    }
+
+    /**
+     * Adds the moves played in a game, and its result
+     */
+    void add(const Power4Game &game) {
+        if (game.getWidth() != header.width || game.getHeight() != header.height) {
+            throw std::invalid_argument("the game isn't of the size of the record");
+        }
+        std::array<std::uint8_t, 255> columns{};
+        for (unsigned int ply = 0; ply < game.getMoveCount(); ply++) {
+            columns[ply] = static_cast<std::uint8_t>(game.getPlayedColumn(ply));
+        }
+        const std::optional<Power4Player> winner = game.getOptionalWinner();
+        const unsigned int result = winner ? *winner - '0' : game.isDraw() ? 3 : 0;
+        add(std::span(columns.data(), game.getMoveCount()), result);
+    }
+
+    /**
+     * Writes the last block and the index. Called by the destructor, which can't report errors.
+     * @throws std::runtime_error if the file can't be written
+     */
+    void close() {
+        if (closed) return;
+        closed = true;
+        writeBlock();
+        // aligns the index, so that readers can use it where it is
+        const std::array<char, 8> padding{};
+        out.write(padding.data(), static_cast<std::streamsize>(-offset % 8));
+        offset += -offset % 8;
+        const RecordFooter footer{offset, index.size(), games, FOOTER_MAGIC, 0};
+        out.write(reinterpret_cast<const char *>(index.data()),
+                  static_cast<std::streamsize>(index.size() * sizeof(RecordBlockIndex)));
+        out.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+        out.close();
+        check();
+    }
+
+    [[nodiscard]] std::uint64_t getGameCount() const {
+        return games;
+    }
+};
+
+/**
+ * Reads a record file written by GameRecordWriter. The file is mapped in memory, so opening it is instant and the games
+ * are read where they are, without copies. Thread-safe, as it is never modified.
+ */
+class GameRecordReader {
+private:
+    MappedFile file;
+    RecordHeader header{};
+    RecordFooter footer{};
+    const RecordBlockIndex *index = nullptr;
+
+    [[nodiscard]] std::runtime_error corrupted() const {
+        return std::runtime_error("the game record is corrupted");
+    }
+
+public:
+    /**
+     * @throws std::runtime_error if the file can't be read or isn't a valid record
+     */
+    explicit GameRecordReader(const std::string &path) : file(path) {
+        if (file.getSize() < sizeof(RecordHeader) + sizeof(RecordFooter)) {
+            throw std::runtime_error(path + " is not a game record");
+        }
+        std::memcpy(&header, file.getData(), sizeof(RecordHeader));
+        std::memcpy(&footer, file.getData() + file.getSize() - sizeof(RecordFooter), sizeof(RecordFooter));
+        if (header.magic != GameRecordWriter::MAGIC || header.version != GameRecordWriter::VERSION) {
+            throw std::runtime_error(path + " is not a game record of version "
+                                     + std::to_string(GameRecordWriter::VERSION));
+        }
+        // the sizes are checked one at a time, so that a corrupted blockCount can't overflow their sum
+        const std::size_t indexEnd = file.getSize() - sizeof(RecordFooter);
+        if (footer.magic != GameRecordWriter::FOOTER_MAGIC || footer.indexOffset > indexEnd
+            || footer.blockCount != (indexEnd - footer.indexOffset) / sizeof(RecordBlockIndex)
+            || (indexEnd - footer.indexOffset) % sizeof(RecordBlockIndex) != 0) {
+            throw std::runtime_error(path + " is truncated, it may not have been closed");
+        }
+        if (header.bitsPerPly < 2 || header.bitsPerPly > 4 || header.width > 1u << header.bitsPerPly) {
+            throw std::runtime_error(path + " is corrupted");
+        }
+        if (footer.indexOffset % alignof(RecordBlockIndex) != 0) throw std::runtime_error(path + " is corrupted");
+        index = reinterpret_cast<const RecordBlockIndex *>(file.getData() + footer.indexOffset);
+        // getGame relies on the first block starting with the first game
+        if ((footer.gameCount > 0 && footer.blockCount == 0) || (footer.blockCount > 0 && index[0].firstGame != 0)) {
+            throw std::runtime_error(path + " is corrupted");
+        }
+    }
+
+    [[nodiscard]] unsigned int getWidth() const {
+        return header.width;
+    }
+
+    [[nodiscard]] unsigned int getHeight() const {
+        return header.height;
+    }
+
+    [[nodiscard]] std::uint64_t getGameCount() const {
+        return footer.gameCount;
+    }
+
+    [[nodiscard]] std::uint64_t getBlockCount() const {
+        return footer.blockCount;
+    }
+
+    /**
+     * Calls f with each game of a block in order, blocks can be read by different threads
+     * @throws std::runtime_error if the block goes out of the file or holds something that isn't a game
+     */
+    template<typename F>
+    void forEachGameInBlock(std::uint64_t block, F &&f) const {
+        if (block >= footer.blockCount) throw std::out_of_range("block out of range");
+        const std::uint64_t offset = index[block].offset;
+        if (offset + sizeof(RecordBlockHeader) > footer.indexOffset) throw corrupted();
+        RecordBlockHeader blockHeader{};
+        std::memcpy(&blockHeader, file.getData() + offset, sizeof(RecordBlockHeader));
+        const auto *next = reinterpret_cast<const std::uint8_t *>(file.getData() + offset + sizeof(RecordBlockHeader));
+        const std::uint8_t *end = next + blockHeader.bytes;
+        if (offset + sizeof(RecordBlockHeader) + blockHeader.bytes > footer.indexOffset) throw corrupted();
+        for (std::uint32_t i = 0; i < blockHeader.gameCount; i++) {
+            if (end - next < 2) throw corrupted();
+            const unsigned int plies = next[0];
+            // the writer never writes these, and the readers index arrays with the result
+            if (plies > header.width * header.height || next[1] > 3) throw corrupted();
+            const std::size_t bytes = RecordedGame::packedBytes(plies, header.bitsPerPly);
+            if (static_cast<std::size_t>(end - next - 2) < bytes) throw corrupted();
+            f(RecordedGame(next + 2, plies, next[1], header.bitsPerPly));
+            next += 2 + bytes;
+        }
+    }
+
+    /**
+     * Calls f with each game in order
+     */
+    template<typename F>
+    void forEachGame(F &&f) const {
+        for (std::uint64_t block = 0; block < footer.blockCount; block++) {
+            forEachGameInBlock(block, f);
+        }
+    }
+
+    /**
+     * Finds a game with the index of the blocks, then reads its block up to it
+     * @throws std::out_of_range if there are fewer games
+     * @throws std::runtime_error if the index doesn't have the game
+     */
+    [[nodiscard]] RecordedGame getGame(std::uint64_t gameIndex) const {
+        if (gameIndex >= footer.gameCount) throw std::out_of_range("there are only "
+                                                                   + std::to_string(footer.gameCount) + " games");
+        const RecordBlockIndex *blockEnd = index + footer.blockCount;
+        const RecordBlockIndex *block = std::upper_bound(index, blockEnd, gameIndex,
+                                                         [](std::uint64_t game, const RecordBlockIndex &entry) {
+                                                             return game < entry.firstGame;
+                                                         });
+        if (block == index) throw corrupted();
+        block--;
+        std::optional<RecordedGame> found;
+        std::uint64_t current = block->firstGame;
+        forEachGameInBlock(block - index, [&](const RecordedGame &game) {
+            if (current++ == gameIndex) found = game;
+        });
+        if (!found) throw corrupted();
+        return *found;
+    }
+};
+
+
+#endif //POWER4_GAMERECORD_HPP
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "GameRecord.hpp"
+
+/**
+ * Reads games in the column string notation, one per line (see toColumnString), checks them by playing them and
+ * writes them to a record
+ * @return the number of games
+ */
+std::uint64_t pack(std::istream &in, const std::string &path, unsigned int width, unsigned int height) {
+    GameRecordWriter writer(path, width, height);
+    const Power4Game emptyBoard(static_cast<int>(width), static_cast<int>(height));
+    Power4Game game = emptyBoard;
+    std::string line;
+    unsigned long lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string moves;
+        if (!(fields >> moves) || moves[0] == '#') continue;
+        game = emptyBoard;
+        for (std::uint8_t column: parseColumnString(moves, width)) {
+            if (game.hasWinner() || !game.addInColumn(column, game.getMoveCount() % 2 == 0 ? '1' : '2')) {
+                throw std::invalid_argument(std::format("line {}: {} can't be played", lineNumber, moves));
+            }
+        }
+        writer.add(game);
+    }
+    writer.close();
+    return writer.getGameCount();
+}
+
+/**
+ * Usage:
+ *   Power4Record pack [--size WxH] <file> <record>  writes the games of a text file (or - for stdin) to a record
+ *   Power4Record unpack <record>                    prints the games of a record, with their result
+ *   Power4Record replay <record>                    replays all the games and prints the plies per second
+ *
+ * See GameRecord.hpp for the format of the records. The text files have one game per line in the column string
+ * notation: the columns played, numbered from 1, like "4453", then from a for the tenth one, or "-" for a game without
+ * moves.
+ */
+int main(int argc, char *argv[]) {
+    try {
+        std::vector<std::string> args(argv + 1, argv + argc);
+        unsigned int width = 7, height = 6;
+        if (args.size() >= 3 && args[1] == "--size") {
+            const std::size_t x = args[2].find('x');
+            if (x == std::string::npos) throw std::invalid_argument("the size must look like 7x6");
+            width = std::stoul(args[2].substr(0, x));
+            height = std::stoul(args[2].substr(x + 1));
+            args.erase(args.begin() + 1, args.begin() + 3);
+        }
+
+        if (args.size() == 3 && args[0] == "pack") {
+            std::uint64_t games;
+            if (args[1] == "-") {
+                games = pack(std::cin, args[2], width, height);
+            } else {
+                std::ifstream in(args[1]);
+                if (!in) throw std::runtime_error("cannot open " + args[1]);
+                games = pack(in, args[2], width, height);
+            }
+            std::cout << games << " games written to " << args[2] << std::endl;
+            return 0;
+        }
+
+        if (args.size() == 2 && args[0] == "unpack") {
+            const GameRecordReader reader(args[1]);
+            static constexpr const char *results[] = {"unfinished", "1 won", "2 won", "draw"};
+            reader.forEachGame([](const RecordedGame &game) {
+                std::cout << std::format("{:<44} {}", toColumnString(game.getColumns()), results[game.getResult()])
+                          << std::endl;
+            });
+            return 0;
+        }
+
+        if (args.size() == 2 && args[0] == "replay") {
+            const GameRecordReader reader(args[1]);
+            using clock = std::chrono::steady_clock;
+            std::uint64_t plies = 0, invalid = 0;
+            const Power4Game emptyBoard(static_cast<int>(reader.getWidth()), static_cast<int>(reader.getHeight()));
+            Power4Game game = emptyBoard;
+            auto start = clock::now();
+            reader.forEachGame([&](const RecordedGame &recorded) {
+                game = emptyBoard;
+                if (!recorded.replay(game)) invalid++;
+                plies += recorded.getPlyCount();
+            });
+            const double gameSeconds = std::chrono::duration<double>(clock::now() - start).count();
+            std::cout << std::format("{} games, {} plies replayed in Power4Game in {:.3f} s: {:.0f} plies/s, {} "
+                                     "invalid", reader.getGameCount(), plies, gameSeconds, plies / gameSeconds,
+                                     invalid) << std::endl;
+
+            if (BitBoard::fits(reader.getWidth(), reader.getHeight())) {
+                std::uint64_t discs = 0;
+                start = clock::now();
+                reader.forEachGame([&](const RecordedGame &recorded) {
+                    BitBoard bitBoard(reader.getWidth(), reader.getHeight());
+                    recorded.replay(bitBoard);
+                    discs += bitBoard.countDiscs();
+                });
+                const double bitBoardSeconds = std::chrono::duration<double>(clock::now() - start).count();
+                std::cout << std::format("{} plies replayed in BitBoard in {:.3f} s: {:.0f} plies/s", discs,
+                                         bitBoardSeconds, discs / bitBoardSeconds) << std::endl;
+            }
+            return invalid == 0 ? 0 : 1;
+        }
+
+        std::cerr << "Usage: Power4Record pack [--size WxH] <file> <record> | unpack <record> | replay <record>"
+                  << std::endl;
+        return 2;
+    } catch (const TracedException &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        e.printTrace();
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,279 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_SELFPLAY_HPP
+#define POWER4_SELFPLAY_HPP
+
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../ai/AlphaBetaSearch.hpp"
+#include "../ai/RandomEngine.hpp"
+#include "../ai/MonteCarloSearch.hpp"
+#include "../record/GameRecord.hpp"
+
+struct SelfPlayOptions {
+    /**
+     * The two engines: "random", "ab" followed by a depth (like "ab6") for an AlphaBetaSearch, or "mcts" followed by
+     * a number of playouts (like "mcts10000") for a MonteCarloSearch. Engine A plays first in the even games and
+     * second in the odd ones.
+     */
+    std::string engineA = "ab4", engineB = "random";
+    std::uint64_t games = 1000;
+    unsigned int threads = 0; // 0 for one per hardware thread, the games are the same with any number of threads
+    /**
+     * Number of random moves played before the engines take over, so that deterministic engines don't play the same
+     * game over and over
+     */
+    unsigned int openingMoves = 4;
+    std::uint64_t seed = 1;
+    std::size_t tableBytes = 1 << 20; // transposition table of each AlphaBetaSearch, cleared before each game
+    std::size_t treeBytes = 16 << 20; // tree of each MonteCarloSearch, dropped before each game
+    unsigned int width = 7, height = 6;
+};
+
+struct SelfPlayStats {
+    std::uint64_t games = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t firstPlayerWins = 0;
+    std::uint64_t winsA = 0, winsB = 0;
+    std::chrono::nanoseconds elapsed{0};
+
+    SelfPlayStats &operator+=(const SelfPlayStats &other) {
+        games += other.games;
+        moves += other.moves;
+        draws += other.draws;
+        firstPlayerWins += other.firstPlayerWins;
+        winsA += other.winsA;
+        winsB += other.winsB;
+        return *this;
+    }
+
+    [[nodiscard]] double gamesPerSecond() const {
+        return elapsed.count() == 0 ? 0 : static_cast<double>(games) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+/**
+ * An engine of SelfPlayOptions, read from its name without building it
+ */
+struct EngineSpec {
+    enum class Kind {
+        RANDOM,
+        ALPHA_BETA,
+        MONTE_CARLO
+    };
+
+    Kind kind = Kind::RANDOM;
+    std::uint64_t budget = 0; // the depth or the number of playouts
+
+    /**
+     * @param spec see SelfPlayOptions::engineA
+     * @throws std::invalid_argument if the spec is not an engine
+     */
+    static EngineSpec parse(const std::string &spec) {
+        const auto numberAfter = [&](const std::string &prefix) -> std::optional<std::uint64_t> {
+            if (spec.size() <= prefix.size() || spec.rfind(prefix, 0) != 0
+                || spec.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+                return std::nullopt;
+            }
+            return std::stoull(spec.substr(prefix.size()));
+        };
+        if (spec == "random") return {Kind::RANDOM, 0};
+        if (const std::optional<std::uint64_t> depth = numberAfter("ab")) {
+            if (*depth == 0 || *depth > AlphaBetaSearch::MAX_DEPTH) {
+                throw std::invalid_argument("the depth of " + spec + " must be between 1 and "
+                                            + std::to_string(AlphaBetaSearch::MAX_DEPTH));
+            }
+            return {Kind::ALPHA_BETA, *depth};
+        }
+        if (const std::optional<std::uint64_t> playouts = numberAfter("mcts")) {
+            if (*playouts < 2) throw std::invalid_argument(spec + " needs at least 2 playouts");
+            return {Kind::MONTE_CARLO, *playouts};
+        }
+        throw std::invalid_argument("unknown engine " + spec + ", expected random, ab<depth> or mcts<playouts>");
+    }
+};
+
+/**
+ * @param tableBytes the transposition table of an AlphaBetaSearch
+ * @param treeBytes the tree of a MonteCarloSearch
+ */
+inline std::unique_ptr<Engine> makeEngine(const EngineSpec &spec, std::size_t tableBytes, std::size_t treeBytes,
+                                          std::uint64_t seed) {
+    switch (spec.kind) {
+        case EngineSpec::Kind::ALPHA_BETA: {
+            auto search = std::make_unique<AlphaBetaSearch>(static_cast<unsigned int>(spec.budget), tableBytes);
+            search->setThreadCount(1);
+            return search;
+        }
+        case EngineSpec::Kind::MONTE_CARLO:
+            return std::make_unique<MonteCarloSearch>(spec.budget, treeBytes, seed);
+        case EngineSpec::Kind::RANDOM:
+        default:
+            return std::make_unique<RandomEngine>(seed);
+    }
+}
+
+/**
+ * Makes an engine play the next game as if it had just been created with this seed: forgets its transposition table
+ * or its tree, and reseeds its random moves
+ */
+inline void resetEngine(Engine &engine, std::uint64_t seed) {
+    if (auto *randomEngine = dynamic_cast<RandomEngine *>(&engine)) {
+        randomEngine->reseed(seed);
+    } else if (auto *alphaBeta = dynamic_cast<AlphaBetaSearch *>(&engine)) {
+        alphaBeta->getTranspositionTable().clear();
+    } else if (auto *monteCarlo = dynamic_cast<MonteCarloSearch *>(&engine)) {
+        monteCarlo->clearTree();
+        monteCarlo->setSeed(seed);
+    }
+}
+
+/**
+ * Plays games between two engines on several threads, without printing anything.
+ * @param writer where to add the games in their order, engine A playing first in the even ones, or nullptr to only
+ * count them. It must be of the size of the board, and is left open.
+ * @param progress called about every second from the calling thread with the statistics so far, can be empty
+ */
+inline SelfPlayStats runSelfPlay(const SelfPlayOptions &options, GameRecordWriter *writer,
+                                 const std::function<void(const SelfPlayStats &)> &progress = {}) {
+    const auto start = std::chrono::steady_clock::now();
+    unsigned int threadCount = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    // check the engines before starting the threads
+    const std::array<EngineSpec, 2> specs = {EngineSpec::parse(options.engineA), EngineSpec::parse(options.engineB)};
+
+    if (options.openingMoves >= options.width * options.height) {
+        throw std::invalid_argument("the opening must leave at least one move to the engines");
+    }
+    std::atomic<std::uint64_t> nextGame = 0;
+    std::atomic<unsigned int> runningThreads = threadCount;
+    std::vector<SelfPlayStats> threadStats(threadCount);
+    std::vector<std::atomic<std::uint64_t>> threadGames(threadCount);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    // the games that ended before one that comes first in the record, by number
+    std::mutex writerMutex;
+    std::map<std::uint64_t, std::pair<std::vector<std::uint8_t>, unsigned int>> waitingGames;
+    std::uint64_t nextGameToWrite = 0;
+
+    auto work = [&](unsigned int index) {
+        try {
+            std::array<std::unique_ptr<Engine>, 2> engines = {
+                    makeEngine(specs[0], options.tableBytes, options.treeBytes, 0),
+                    makeEngine(specs[1], options.tableBytes, options.treeBytes, 0)};
+            SelfPlayStats &stats = threadStats[index];
+            std::vector<std::uint8_t> columns;
+            columns.reserve(options.width * options.height);
+            std::mt19937_64 random;
+            // assigning the empty board to the board of the last game reuses its memory
+            const Power4Game emptyBoard(static_cast<int>(options.width), static_cast<int>(options.height));
+            Power4Game board = emptyBoard;
+            for (std::uint64_t game = nextGame++; game < options.games; game = nextGame++) {
+                // the game only depends on the seed and on its number, not on the thread or the games played before
+                random.seed(options.seed ^ (game * 0x9e3779b97f4a7c15));
+                for (std::unique_ptr<Engine> &engine: engines) {
+                    resetEngine(*engine, random());
+                }
+                const bool engineAFirst = game % 2 == 0;
+                board = emptyBoard;
+                columns.clear();
+                while (!board.hasWinner() && !board.isDraw()) {
+                    const Power4Player player = board.getMoveCount() % 2 == 0 ? '1' : '2';
+                    unsigned int column;
+                    if (columns.size() < options.openingMoves) {
+                        column = static_cast<unsigned int>(random() % options.width);
+                        if (!board.addInColumn(column, player)) continue;
+                        if (board.hasWinner() || board.isDraw()) {
+                            // the opening must leave a game to play, start it again
+                            board = emptyBoard;
+                            columns.clear();
+                            continue;
+                        }
+                    } else {
+                        const bool isEngineA = (player == '1') == engineAFirst;
+                        column = engines[isEngineA ? 0 : 1]->search(board, player).column;
+                        board.addInColumn(column, player);
+                    }
+                    columns.push_back(static_cast<std::uint8_t>(column));
+                }
+
+                const std::optional<Power4Player> winner = board.getOptionalWinner();
+                const unsigned int winnerIndex = winner ? *winner - '0' : 0;
+                stats.games++;
+                stats.moves += columns.size();
+                if (winnerIndex == 0) stats.draws++;
+                else if (winnerIndex == 1) stats.firstPlayerWins++;
+                if (winnerIndex != 0) ((winnerIndex == 1) == engineAFirst ? stats.winsA : stats.winsB)++;
+                threadGames[index].store(stats.games, std::memory_order_relaxed);
+
+                if (writer != nullptr) {
+                    std::lock_guard lock(writerMutex);
+                    waitingGames.try_emplace(game, columns, winnerIndex == 0 ? 3 : winnerIndex);
+                    for (auto it = waitingGames.begin(); it != waitingGames.end() && it->first == nextGameToWrite;
+                         it = waitingGames.erase(it)) {
+                        writer->add(it->second.first, it->second.second);
+                        nextGameToWrite++;
+                    }
+                }
+            }
+        } catch (...) {
+            std::lock_guard lock(errorMutex);
+            if (!error) error = std::current_exception();
+            nextGame = options.games; // stop the other threads
+        }
+        runningThreads--;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        threads.emplace_back(work, i);
+    }
+    if (progress) {
+        // only the number of games is shared while playing, the other counters are read after the threads are joined
+        auto lastReport = std::chrono::steady_clock::now();
+        while (runningThreads.load() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (std::chrono::steady_clock::now() - lastReport >= std::chrono::seconds(1)) {
+                lastReport = std::chrono::steady_clock::now();
+                SelfPlayStats partial;
+                for (const std::atomic<std::uint64_t> &count: threadGames) {
+                    partial.games += count.load(std::memory_order_relaxed);
+                }
+                partial.elapsed = lastReport - start;
+                progress(partial);
+            }
+        }
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    if (error) std::rethrow_exception(error);
+
+    SelfPlayStats total;
+    for (const SelfPlayStats &stats: threadStats) {
+        total += stats;
+    }
+    total.elapsed = std::chrono::steady_clock::now() - start;
+    return total;
+}
+
+
+#endif //POWER4_SELFPLAY_HPP
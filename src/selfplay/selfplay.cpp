@@ -0,0 +1,91 @@
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include "SelfPlay.hpp"
+
+/**
+ * Usage: Power4SelfPlay [--games n] [--a engine] [--b engine] [--threads n] [--opening moves] [--seed n]
+ *                       [--table-mb n] [--tree-mb n] [--size WxH] [--output file]
+ *
+ * Plays games between engine A (ab4 by default) and engine B (random by default), see SelfPlayOptions, and prints the
+ * outcomes and the number of games per second. With --output, the games are written in their order to a game record
+ * (see GameRecord.hpp) for Power4Record, Power4Analyze or Power4Book. Progress goes to the standard error, once per
+ * second. The games only depend on the options, not on --threads.
+ *
+ * The strength of MonteCarloSearch against AlphaBetaSearch, 100 games each, sides swapped every game:
+ *   Power4SelfPlay --a mcts20000 --b ab6 --games 100 --opening 4 --seed 1 --table-mb 1 --tree-mb 16
+ *     mcts20000 won 81, ab6 won 12, 7 draws
+ *   Power4SelfPlay --a mcts100000 --b ab8 --games 100 --opening 4 --seed 1 --table-mb 1 --tree-mb 16
+ *     mcts100000 won 77, ab8 won 14, 9 draws
+ */
+int main(int argc, char *argv[]) {
+    try {
+        SelfPlayOptions options;
+        std::optional<std::string> output;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value after " << arg << std::endl;
+                return 2;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--games") options.games = std::stoull(value);
+            else if (arg == "--a") options.engineA = value;
+            else if (arg == "--b") options.engineB = value;
+            else if (arg == "--threads") options.threads = std::stoul(value);
+            else if (arg == "--opening") options.openingMoves = std::stoul(value);
+            else if (arg == "--seed") options.seed = std::stoull(value);
+            else if (arg == "--table-mb") options.tableBytes = std::stoull(value) << 20;
+            else if (arg == "--tree-mb") options.treeBytes = std::stoull(value) << 20;
+            else if (arg == "--size") {
+                const std::size_t x = value.find('x');
+                if (x == std::string::npos) throw std::invalid_argument("the size must look like 7x6");
+                options.width = std::stoul(value.substr(0, x));
+                options.height = std::stoul(value.substr(x + 1));
+            } else if (arg == "--output") output = value;
+            else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return 2;
+            }
+        }
+
+        std::unique_ptr<GameRecordWriter> writer;
+        if (output) writer = std::make_unique<GameRecordWriter>(*output, options.width, options.height);
+
+        std::cout << std::format("{} games of {} against {} on {}x{}, {} random opening moves", options.games,
+                                 options.engineA, options.engineB, options.width, options.height,
+                                 options.openingMoves) << std::endl;
+        const SelfPlayStats stats = runSelfPlay(options, writer.get(), [&](const SelfPlayStats &partial) {
+            std::cerr << std::format("\r{}/{} games, {:.0f} games/s", partial.games, options.games,
+                                     partial.gamesPerSecond()) << std::flush;
+        });
+        std::cerr << std::endl;
+        if (writer) writer->close();
+
+        const auto percent = [&](std::uint64_t count) {
+            return stats.games == 0 ? 0 : 100 * static_cast<double>(count) / static_cast<double>(stats.games);
+        };
+        std::cout << std::format("{} games in {:.2f} s: {:.1f} games/s, {:.0f} moves/s, {:.1f} moves per game",
+                                 stats.games, static_cast<double>(stats.elapsed.count()) / 1e9,
+                                 stats.gamesPerSecond(), stats.gamesPerSecond() * static_cast<double>(stats.moves)
+                                                         / static_cast<double>(stats.games == 0 ? 1 : stats.games),
+                                 static_cast<double>(stats.moves) / static_cast<double>(stats.games == 0 ? 1
+                                                                                                         : stats.games))
+                  << std::endl;
+        std::cout << std::format("A ({}) won {} ({:.1f}%), B ({}) won {} ({:.1f}%), {} draws ({:.1f}%)",
+                                 options.engineA, stats.winsA, percent(stats.winsA), options.engineB, stats.winsB,
+                                 percent(stats.winsB), stats.draws, percent(stats.draws)) << std::endl;
+        std::cout << std::format("The first player won {} games ({:.1f}%)", stats.firstPlayerWins,
+                                 percent(stats.firstPlayerWins)) << std::endl;
+        return 0;
+    } catch (const TracedException &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        e.printTrace();
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
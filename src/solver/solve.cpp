@@ -0,0 +1,130 @@
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../game/Power4Game.hpp"
+#include "../ai/Solver.hpp"
+
+/**
+ * Plays a sequence of columns numbered from 1, like "4453", the players alternating
+ * @return false if a character isn't a column, a column is full or the game ended before the end of the sequence
+ */
+bool playMoves(Power4Game &game, const std::string &moves) {
+    for (char c: moves) {
+        const unsigned int column = c - '1';
+        if (column >= game.getWidth() || game.hasWinner()) return false;
+        if (!game.addInColumn(column, game.getMoveCount() % 2 == 0 ? '1' : '2')) return false;
+    }
+    return true;
+}
+
+std::string describe(const SolveResult &result) {
+    if (result.score == 0) return "draw";
+    return std::format("{} in {}", result.score > 0 ? "win" : "loss", result.plies);
+}
+
+/**
+ * Solves each position of a stream, one per line: the moves played, optionally followed by the expected score.
+ * Empty lines and lines starting with # are ignored.
+ * @return the number of wrong scores
+ */
+unsigned int solveAll(Solver &solver, std::istream &in, const std::string &name, bool analyze) {
+    unsigned int positions = 0, wrong = 0;
+    std::uint64_t totalNodes = 0;
+    std::chrono::nanoseconds totalTime{0};
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string moves;
+        fields >> moves;
+        if (moves == "-") moves.clear(); // the empty board
+        std::optional<int> expected;
+        if (int score; fields >> score) expected = score;
+
+        Power4Game game(static_cast<int>(solver.getWidth()), static_cast<int>(solver.getHeight()));
+        if (!playMoves(game, moves) || game.hasWinner() || game.isDraw()) {
+            std::cout << std::format("{:<42} invalid or finished position", moves) << std::endl;
+            wrong++;
+            continue;
+        }
+        if (analyze) {
+            std::cout << std::format("{:<42}", moves.empty() ? "-" : moves);
+            for (const std::optional<int> &score: solver.analyze(game)) {
+                std::cout << (score ? std::format(" {:>3}", *score) : "   .");
+            }
+            std::cout << std::endl;
+            continue;
+        }
+
+        const SolveResult result = solver.solve(game);
+        positions++;
+        totalNodes += result.nodes;
+        totalTime += result.elapsed;
+        const bool isWrong = expected && *expected != result.score;
+        if (isWrong) wrong++;
+        std::cout << std::format("{:<42} {:>4} {:<12} {:>12} nodes {:>12.3f} ms{}",
+                                 moves.empty() ? "-" : moves, result.score, describe(result), result.nodes,
+                                 static_cast<double>(result.elapsed.count()) / 1e6,
+                                 isWrong ? std::format("  WRONG, expected {}", *expected) : "")
+                  << std::endl;
+    }
+    if (positions > 0) {
+        const double meanMs = static_cast<double>(totalTime.count()) / 1e6 / positions;
+        std::cout << std::format("{}: {} positions, {} wrong, mean {:.3f} ms and {:.0f} nodes per position, {:.0f} "
+                                 "nodes/s", name, positions, wrong, meanMs,
+                                 static_cast<double>(totalNodes) / positions,
+                                 totalTime.count() == 0 ? 0 : static_cast<double>(totalNodes) * 1e9
+                                                              / static_cast<double>(totalTime.count()))
+                  << std::endl;
+    }
+    return wrong;
+}
+
+/**
+ * Usage: Power4Solve [--analyze] [file...]
+ *
+ * Solves 7x6 positions read from the files (or the standard input), one per line: the columns played from the start,
+ * numbered from 1 ("-" for the empty board), optionally followed by the expected score to check it. Prints the score
+ * of each position for the player to play (see SolveResult::score), and the time taken.
+ *
+ * With --analyze, prints the score of each column instead.
+ *
+ * The test sets in src/solver/positions have positions at the end, the middle and the beginning of games.
+ */
+int main(int argc, char *argv[]) {
+    try {
+        bool analyze = false;
+        std::vector<std::string> files;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            if (arg == "--analyze") analyze = true;
+            else files.push_back(arg);
+        }
+
+        Solver solver;
+        unsigned int wrong = 0;
+        if (files.empty()) {
+            wrong += solveAll(solver, std::cin, "stdin", analyze);
+        }
+        for (const std::string &file: files) {
+            std::ifstream in(file);
+            if (!in) throw std::runtime_error("cannot open " + file);
+            // each test set starts from an empty table, so that its timings don't depend on the previous ones
+            solver.reset();
+            wrong += solveAll(solver, in, file, analyze);
+        }
+        return wrong == 0 ? 0 : 1;
+    } catch (const TracedException &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        e.printTrace();
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
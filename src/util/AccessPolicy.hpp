@@ -0,0 +1,48 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_ACCESSPOLICY_HPP
+#define POWER4_ACCESSPOLICY_HPP
+
+#include <cassert>
+#include <string>
+#include "OutOfRangeException.hpp"
+
+/**
+ * Access policy that throws an OutOfRangeException for coordinates outside the board. This is the default of the
+ * public API, where the coordinates come from the outside.
+ */
+struct CheckedAccess {
+    static void check(unsigned int x, unsigned int y, unsigned int width, unsigned int height) {
+        if (x >= width)
+            throw OutOfRangeException(
+                    "x out of range, should be between 0 and " + std::to_string(width) + ", was " + std::to_string(x));
+        if (y >= height)
+            throw OutOfRangeException(
+                    "y out of range, should be between 0 and " + std::to_string(height) + ", was " + std::to_string(y));
+    }
+
+    static void checkPositive(int x, int y) {
+        if (x < 0) throw OutOfRangeException("x out of range, should be positive, was " + std::to_string(x));
+        if (y < 0) throw OutOfRangeException("y out of range, should be positive, was " + std::to_string(y));
+    }
+};
+
+/**
+ * Access policy for coordinates already known to be in the board, like in the loops of the game and of the search.
+ * They are only checked by assertions, in debug builds.
+ */
+struct UncheckedAccess {
+    static void check([[maybe_unused]] unsigned int x, [[maybe_unused]] unsigned int y,
+                      [[maybe_unused]] unsigned int width, [[maybe_unused]] unsigned int height) {
+        assert(x < width && y < height);
+    }
+
+    static void checkPositive([[maybe_unused]] int x, [[maybe_unused]] int y) {
+        assert(x >= 0 && y >= 0);
+    }
+};
+
+
+#endif //POWER4_ACCESSPOLICY_HPP
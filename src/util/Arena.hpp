@@ -0,0 +1,103 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_ARENA_HPP
+#define POWER4_ARENA_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * Memory for many small objects that all die at the same time, like the nodes of a search tree.
+ *
+ * The memory is reserved once, in the constructor. Allocating only moves an offset forward (with an atomic add, so
+ * several threads can allocate at once), nothing is ever freed one by one, and reset frees everything at once in
+ * O(1). Only trivially destructible objects can be created, as no destructor is ever called.
+ *
+ * When the memory runs out, allocations return nullptr rather than throwing: the caller decides what to do, like
+ * stopping to grow a tree.
+ */
+class Arena {
+private:
+    std::unique_ptr<std::byte[]> memory;
+    std::size_t capacity;
+    std::atomic<std::size_t> offset = 0;
+    std::atomic<std::uint64_t> allocations = 0;
+
+public:
+    /**
+     * @param bytes the memory reserved, pages are only really used by the OS when they are written to
+     */
+    explicit Arena(std::size_t bytes) : memory(new std::byte[bytes]), capacity(bytes) {
+        if (bytes == 0) throw std::invalid_argument("an arena needs some memory");
+    }
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * Thread-safe.
+     * @return size bytes aligned on align (a power of 2), or nullptr if the arena is full
+     */
+    void *allocate(std::size_t size, std::size_t align) {
+        const auto base = reinterpret_cast<std::uintptr_t>(memory.get());
+        std::size_t start = offset.load(std::memory_order_relaxed);
+        std::size_t aligned;
+        do {
+            aligned = ((base + start + align - 1) & ~(align - 1)) - base;
+            if (aligned + size > capacity) return nullptr;
+        } while (!offset.compare_exchange_weak(start, aligned + size, std::memory_order_relaxed));
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return memory.get() + aligned;
+    }
+
+    /**
+     * Constructs count objects in a row with their default constructor. Thread-safe.
+     * @return the first object, or nullptr if the arena is full
+     */
+    template<typename T>
+    T *create(std::size_t count = 1) {
+        static_assert(std::is_trivially_destructible_v<T>, "the destructors of objects in an arena are never called");
+        void *objects = allocate(sizeof(T) * count, alignof(T));
+        if (objects == nullptr) return nullptr;
+        T *first = static_cast<T *>(objects);
+        for (std::size_t i = 0; i < count; i++) {
+            new(first + i) T();
+        }
+        return first;
+    }
+
+    /**
+     * Forgets all the objects at once. Must not be called while other threads allocate.
+     */
+    void reset() {
+        offset.store(0, std::memory_order_relaxed);
+        allocations.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t getUsed() const {
+        return offset.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    /**
+     * @return the number of allocations since the last reset
+     */
+    [[nodiscard]] std::uint64_t getAllocations() const {
+        return allocations.load(std::memory_order_relaxed);
+    }
+};
+
+
+#endif //POWER4_ARENA_HPP
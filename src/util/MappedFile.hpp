@@ -0,0 +1,130 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_MAPPEDFILE_HPP
+#define POWER4_MAPPEDFILE_HPP
+
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A file mapped in memory, read-only. The pages are loaded by the OS when they are first read, so opening a big file
+ * costs nothing and the file is never copied.
+ */
+class MappedFile {
+private:
+    const std::byte *data = nullptr;
+    std::size_t size = 0;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    void close() {
+#if defined(_WIN32)
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr) munmap(const_cast<std::byte *>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+public:
+    /**
+     * @throws std::runtime_error if the file can't be opened
+     */
+    explicit MappedFile(const std::string &path) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            close();
+            throw std::runtime_error("cannot read the size of " + path);
+        }
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+        if (size == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            data = static_cast<const std::byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (data == nullptr) {
+            close();
+            throw std::runtime_error("cannot map " + path);
+        }
+#else
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) throw std::runtime_error("cannot open " + path);
+        struct stat status{};
+        if (fstat(descriptor, &status) != 0) {
+            ::close(descriptor);
+            throw std::runtime_error("cannot read the size of " + path);
+        }
+        size = static_cast<std::size_t>(status.st_size);
+        if (size > 0) {
+            void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapped != MAP_FAILED) data = static_cast<const std::byte *>(mapped);
+        }
+        ::close(descriptor); // the mapping stays valid
+        if (size > 0 && data == nullptr) {
+            size = 0;
+            throw std::runtime_error("cannot map " + path);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+#if defined(_WIN32)
+            std::swap(file, other.file);
+            std::swap(mapping, other.mapping);
+#endif
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    [[nodiscard]] const std::byte *getData() const {
+        return data;
+    }
+
+    [[nodiscard]] std::size_t getSize() const {
+        return size;
+    }
+};
+
+
+#endif //POWER4_MAPPEDFILE_HPP
@@ -5,6 +5,8 @@
 #ifndef POWER4_MATH_UTILS_CPP
 #define POWER4_MATH_UTILS_CPP
 
+#include <cstdint>
+
 int intPow(int base, unsigned int exp) {
     int res = 1;
     while (exp) {
@@ -16,4 +18,14 @@ int intPow(int base, unsigned int exp) {
     return res;
 }
 
+/**
+ * SplitMix64 finalizer: a cheap bijective function whose output looks random, used to derive hash keys
+ */
+constexpr std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
 #endif //POWER4_MATH_UTILS_CPP
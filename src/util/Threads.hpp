@@ -0,0 +1,39 @@
+//
+// Created by bananasmoothii on 16/10/2026.
+//
+
+#ifndef POWER4_THREADS_HPP
+#define POWER4_THREADS_HPP
+
+
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * Pins the calling thread to a CPU, wrapping around if there are fewer CPUs
+ * @return true if it worked, false if it failed or is not supported on this platform
+ */
+inline bool pinCurrentThread(unsigned int cpu) {
+    unsigned int cpuCount = std::thread::hardware_concurrency();
+    if (cpuCount != 0) cpu %= cpuCount;
+#if defined(_WIN32)
+    if (cpu >= 8 * sizeof(DWORD_PTR)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    return false;
+#endif
+}
+
+
+#endif //POWER4_THREADS_HPP
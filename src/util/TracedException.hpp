@@ -8,37 +8,61 @@
 
 #include <stdexcept>
 #include <vector>
-#include <cpptrace/cpptrace.hpp>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <cstdint>
 #include <color.hpp>
-#include "../../cmake-build-debug/_deps/cpptrace-src/src/platform/common.hpp"
+#ifndef POWER4_NO_TRACING
+#include <cpptrace/cpptrace.hpp>
+#endif
 
+/**
+ * Exception that remembers where it was thrown from. Only the addresses of the frames are captured when it is thrown,
+ * they are resolved to functions and lines in printTrace, so throwing stays cheap.
+ *
+ * Define POWER4_NO_TRACING (CMake option POWER4_TRACING=OFF) to capture nothing and build without cpptrace.
+ */
 class TracedException : public std::runtime_error {
 private:
-    std::vector<cpptrace::stacktrace_frame> trace;
+#ifndef POWER4_NO_TRACING
+    cpptrace::raw_trace trace;
+#endif
+
+    static int digitCount(std::size_t n) {
+        int digits = 1;
+        while (n >= 10) {
+            n /= 10;
+            digits++;
+        }
+        return digits;
+    }
+
 public:
     explicit TracedException(const std::string &message) : runtime_error(message) {
-        trace = cpptrace::generate_trace();
+#ifndef POWER4_NO_TRACING
+        trace = cpptrace::generate_raw_trace();
+#endif
     }
 
     void printTrace() const {
         // implementation stolen from cpptrace as it doesn't provide a way to print the trace to a stream
         std::cerr << dye::red("Stack trace (most recent call first):") << std::endl;
+#ifdef POWER4_NO_TRACING
+        std::cerr << "<tracing disabled>" << std::endl;
+#else
+        const std::vector<cpptrace::stacktrace_frame> frames = trace.resolve().frames;
         std::size_t counter = 0;
-        if (trace.empty()) {
+        if (frames.empty()) {
             std::cerr << "<empty trace>" << std::endl;
             return;
         }
-        const auto frame_number_width = n_digits(static_cast<int>(trace.size()) - 2);
-        for (const auto &frame: trace) {
-            if (++counter == 0)
-                continue;
-
+        const auto frame_number_width = digitCount(frames.size());
+        for (const auto &frame: frames) {
+            ++counter;
             std::cerr
                     << '#'
-                    << std::setw(static_cast<int>(frame_number_width))
+                    << std::setw(frame_number_width)
                     << std::left
                     << counter
                     << std::right
@@ -65,12 +89,12 @@ public:
                     << frame.line
                     << hue::reset;
 
-            //<< (frame.col > 0 ? ":" + dye::blue(std::to_string(frame.col)) : "")
-            if (frame.col > 0) {
-                std::cerr << ":" << dye::blue(std::to_string(frame.col));
+            if (frame.column > 0 && frame.column != UINT_LEAST32_MAX) {
+                std::cerr << ":" << dye::blue(std::to_string(frame.column));
             }
             std::cerr << std::endl;
         }
+#endif
     }
 };
 